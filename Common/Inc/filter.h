@@ -0,0 +1,63 @@
+/*
+ * filter.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+
+#ifndef FILTER_H_
+#define FILTER_H_
+
+#include <stdint.h>
+
+/* Every *_block() function eats n samples spaced stride apart, so a single
+ * channel can be filtered straight out of an interleaved ADC DMA buffer.
+ * Accumulators are 32-bit fixed point, results are in ADC units again. */
+
+/* Exponential average y += (x - y) / 2^shift, acc holds y in Q(shift) */
+typedef struct {
+	uint32_t acc;
+	uint8_t shift;
+} filter_ema_t;
+
+/* Moving average of the last len samples kept as a running sum */
+#define FILTER_MA_MAX 32
+typedef struct {
+	uint16_t hist[FILTER_MA_MAX];
+	uint32_t sum;
+	uint8_t len;
+	uint8_t pos;
+} filter_ma_t;
+
+/* Median of the last len samples, len odd */
+#define FILTER_MEDIAN_MAX 9
+typedef struct {
+	uint16_t hist[FILTER_MEDIAN_MAX];
+	uint8_t len;
+	uint8_t pos;
+} filter_median_t;
+
+/* CIC decimator by 2^log2_rate, FILTER_CIC_ORDER stages. Registers wrap
+ * modulo 2^32, which is fine while 16 + ORDER * log2_rate <= 32. */
+#define FILTER_CIC_ORDER 2
+typedef struct {
+	uint32_t integ[FILTER_CIC_ORDER];
+	uint32_t comb[FILTER_CIC_ORDER];
+	uint8_t log2_rate;
+	uint16_t phase;
+} filter_cic_t;
+
+void filter_ema_init(filter_ema_t *f, uint8_t shift, uint16_t initial);
+uint16_t filter_ema_block(filter_ema_t *f, const uint16_t *x, uint32_t n, uint32_t stride);
+
+void filter_ma_init(filter_ma_t *f, uint8_t len, uint16_t initial);
+uint16_t filter_ma_block(filter_ma_t *f, const uint16_t *x, uint32_t n, uint32_t stride);
+
+void filter_median_init(filter_median_t *f, uint8_t len, uint16_t initial);
+uint16_t filter_median_block(filter_median_t *f, const uint16_t *x, uint32_t n, uint32_t stride);
+
+/* Writes one output per 2^log2_rate inputs to out, returns their count */
+void filter_cic_init(filter_cic_t *f, uint8_t log2_rate);
+uint32_t filter_cic_block(filter_cic_t *f, const uint16_t *x, uint32_t n, uint32_t stride, uint16_t *out);
+
+#endif /* FILTER_H_ */
@@ -0,0 +1,107 @@
+/*
+ * filter.c
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+#include <stdint.h>
+#include "filter.h"
+
+
+void filter_ema_init(filter_ema_t *f, uint8_t shift, uint16_t initial) {
+	f->shift = shift;
+	f->acc = (uint32_t) initial << shift;
+}
+
+uint16_t filter_ema_block(filter_ema_t *f, const uint16_t *x, uint32_t n, uint32_t stride) {
+	uint32_t acc = f->acc;
+	for (uint32_t i = 0; i < n; i++, x += stride) {
+		acc -= acc >> f->shift;
+		acc += *x;
+	}
+	f->acc = acc;
+	return acc >> f->shift;
+}
+
+void filter_ma_init(filter_ma_t *f, uint8_t len, uint16_t initial) {
+	if (len == 0 || len > FILTER_MA_MAX) len = FILTER_MA_MAX;
+	f->len = len;
+	f->pos = 0;
+	f->sum = (uint32_t) initial * len;
+	for (uint8_t i = 0; i < len; i++) {
+		f->hist[i] = initial;
+	}
+}
+
+uint16_t filter_ma_block(filter_ma_t *f, const uint16_t *x, uint32_t n, uint32_t stride) {
+	for (uint32_t i = 0; i < n; i++, x += stride) {
+		f->sum += *x;
+		f->sum -= f->hist[f->pos]; // oldest sample leaves the window;
+		f->hist[f->pos] = *x;
+		if (++f->pos >= f->len) f->pos = 0;
+	}
+	return f->sum / f->len;
+}
+
+void filter_median_init(filter_median_t *f, uint8_t len, uint16_t initial) {
+	if (len == 0 || len > FILTER_MEDIAN_MAX) len = FILTER_MEDIAN_MAX;
+	if ((len & 1) == 0) len--;
+	f->len = len;
+	f->pos = 0;
+	for (uint8_t i = 0; i < len; i++) {
+		f->hist[i] = initial;
+	}
+}
+
+uint16_t filter_median_block(filter_median_t *f, const uint16_t *x, uint32_t n, uint32_t stride) {
+	uint16_t sorted[FILTER_MEDIAN_MAX];
+
+	/* only the last len samples of the block can reach the output */
+	if (n > f->len) {
+		x += (n - f->len) * stride;
+		n = f->len;
+	}
+	for (uint32_t i = 0; i < n; i++, x += stride) {
+		f->hist[f->pos] = *x;
+		if (++f->pos >= f->len) f->pos = 0;
+	}
+
+	for (uint8_t i = 0; i < f->len; i++) { // insertion sort, len is tiny;
+		uint16_t v = f->hist[i];
+		uint8_t j = i;
+		for (; j > 0 && sorted[j - 1] > v; j--) {
+			sorted[j] = sorted[j - 1];
+		}
+		sorted[j] = v;
+	}
+	return sorted[f->len / 2];
+}
+
+void filter_cic_init(filter_cic_t *f, uint8_t log2_rate) {
+	f->log2_rate = log2_rate;
+	f->phase = 0;
+	for (uint8_t k = 0; k < FILTER_CIC_ORDER; k++) {
+		f->integ[k] = 0;
+		f->comb[k] = 0;
+	}
+}
+
+uint32_t filter_cic_block(filter_cic_t *f, const uint16_t *x, uint32_t n, uint32_t stride, uint16_t *out) {
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < n; i++, x += stride) {
+		uint32_t v = *x;
+		for (uint8_t k = 0; k < FILTER_CIC_ORDER; k++) {
+			f->integ[k] += v;
+			v = f->integ[k];
+		}
+		if (++f->phase < (1U << f->log2_rate)) continue;
+		f->phase = 0;
+		for (uint8_t k = 0; k < FILTER_CIC_ORDER; k++) {
+			uint32_t prev = f->comb[k];
+			f->comb[k] = v;
+			v -= prev;
+		}
+		out[count++] = v >> (FILTER_CIC_ORDER * f->log2_rate); // remove the R^N gain;
+	}
+	return count;
+}
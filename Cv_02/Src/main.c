@@ -18,6 +18,7 @@
 
 #include <stdint.h>
 #include "stm32f030x8.h"
+#include "sched.h"
 
 #if !defined(__SOFT_FP__) && defined(__ARM_FP)
   #warning "FPU is not initialized, but the project is compiling for an FPU. Please initialize the FPU before use."
@@ -27,7 +28,7 @@
 void blikac(void);
 void tlacitka(void);
 
-uint32_t Tick;
+volatile uint32_t Tick;
 
 int main(void) {
 
@@ -42,45 +43,41 @@ int main(void) {
 	EXTI->FTSR |= EXTI_FTSR_TR0; // trigger on falling edge
 	//NVIC_EnableIRQ(EXTI0_1_IRQn); // enable EXTI0_1
 	SysTick_Config(8000); // init SysTick timer 8Mhz;
+	sched_every(5, tlacitka);
+	//sched_every(300, blikac);
 
 	/**********INFINIT LOOP************/
 	for (;;) {
-		//blikac();
-		tlacitka();
-
+		sched_run();
 	}
 
 }
 
+static void led2_off(void) {
+	GPIOB->BRR = (1 << 0);
+}
+
+static void led1_off(void) {
+	GPIOA->BRR = (1 << 4);
+}
+
 void tlacitka(void) {
 	static uint16_t debounce1 = 0xFFFF;
 	static uint16_t debounce2 = 0xFFFF;
-	static uint32_t off_time1 = 0;
-	static uint32_t off_time2 = 0;
-	static uint32_t delay = 0;
 
-	if (Tick > delay + 5) {
-		delay = Tick;
-		debounce1 <<= 1;
-		debounce2 <<= 1;
-		if (GPIOC->IDR & (1 << 1))
-			debounce1 |= 0x0001;
-		if (debounce1 == 0x8000) {
-			off_time1 = Tick + 500;
-			GPIOB->BSRR = (1 << 0);
-		}
-		if (GPIOC->IDR & (1 << 0))
-			debounce2 |= 0x0001;
-		if (debounce2 == 0x8000) {
-			off_time2 = Tick + 2000;
-			GPIOA->BSRR = (1 << 4);
-		}
-	}
-	if (Tick > off_time1) {
-		GPIOB->BRR = (1 << 0);
+	debounce1 <<= 1;
+	debounce2 <<= 1;
+	if (GPIOC->IDR & (1 << 1))
+		debounce1 |= 0x0001;
+	if (debounce1 == 0x8000) {
+		GPIOB->BSRR = (1 << 0);
+		sched_after(500, led2_off);
 	}
-	if (Tick > off_time2) {
-		GPIOA->BRR = (1 << 4);
+	if (GPIOC->IDR & (1 << 0))
+		debounce2 |= 0x0001;
+	if (debounce2 == 0x8000) {
+		GPIOA->BSRR = (1 << 4);
+		sched_after(2000, led1_off);
 	}
 }
 
@@ -91,12 +88,7 @@ void EXTI0_1_IRQHandler(void) {
 	}
 }
 void blikac(void) {
-	static uint32_t delay;
-
-	if (Tick > delay + 300) {
-		GPIOA->ODR ^= (1 << 4);
-		delay = Tick;
-	}
+	GPIOA->ODR ^= (1 << 4);
 }
 void SysTick_Handler(void) //Make event service of SysTick;
 {
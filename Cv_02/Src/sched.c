@@ -0,0 +1,93 @@
+/*
+ * sched.c
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+#include <stddef.h>
+#include "stm32f030x8.h"
+#include "sched.h"
+
+typedef struct {
+	sched_fn_t fn;
+	uint32_t due;
+	uint32_t period; // 0 for one-shot;
+} sched_task_t;
+
+static sched_task_t sched_tasks[SCHED_MAX_TASKS];
+static uint32_t sched_next; // earliest due time of all tasks;
+static uint8_t sched_pending;
+
+static void sched_update_next(void) {
+	uint32_t now = SCHED_NOW();
+	uint32_t best = UINT32_MAX;
+
+	sched_pending = 0;
+	for (uint8_t i = 0; i < SCHED_MAX_TASKS; i++) {
+		if (sched_tasks[i].fn == NULL) continue;
+		uint32_t left = (int32_t)(sched_tasks[i].due - now) < 0 ? 0 : sched_tasks[i].due - now;
+		if (left < best) best = left;
+		sched_pending = 1;
+	}
+	sched_next = now + best;
+}
+
+static uint8_t sched_add(uint32_t ms, uint32_t period, sched_fn_t fn) {
+	sched_task_t *slot = NULL;
+
+	for (uint8_t i = 0; i < SCHED_MAX_TASKS; i++) {
+		if (sched_tasks[i].fn == fn) {
+			slot = &sched_tasks[i];
+			break;
+		}
+		if (slot == NULL && sched_tasks[i].fn == NULL) slot = &sched_tasks[i];
+	}
+	if (slot == NULL) return 0;
+
+	slot->due = SCHED_NOW() + ms;
+	slot->period = period;
+	slot->fn = fn;
+	if (!sched_pending || (int32_t)(slot->due - sched_next) < 0) {
+		sched_next = slot->due;
+		sched_pending = 1;
+	}
+	return 1;
+}
+
+uint8_t sched_every(uint32_t ms, sched_fn_t fn) {
+	return sched_add(ms, ms, fn);
+}
+
+uint8_t sched_after(uint32_t ms, sched_fn_t fn) {
+	return sched_add(ms, 0, fn);
+}
+
+void sched_cancel(sched_fn_t fn) {
+	for (uint8_t i = 0; i < SCHED_MAX_TASKS; i++) {
+		if (sched_tasks[i].fn == fn) sched_tasks[i].fn = NULL;
+	}
+	sched_update_next();
+}
+
+void sched_run(void) {
+	uint32_t now = SCHED_NOW();
+
+	if (!sched_pending || (int32_t)(now - sched_next) < 0) {
+		__WFI(); // a tick interrupt wakes us up again;
+		return;
+	}
+	for (uint8_t i = 0; i < SCHED_MAX_TASKS; i++) {
+		sched_task_t *t = &sched_tasks[i];
+		sched_fn_t fn = t->fn;
+
+		if (fn == NULL || (int32_t)(now - t->due) < 0) continue;
+		if (t->period == 0) {
+			t->fn = NULL; // free the slot first so fn can re-arm itself;
+		} else {
+			t->due += t->period;
+			if ((int32_t)(now - t->due) >= 0) t->due = now + t->period; // skip missed periods;
+		}
+		fn();
+	}
+	sched_update_next();
+}
@@ -0,0 +1,31 @@
+/*
+ * calib.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+
+#ifndef CALIB_H_
+#define CALIB_H_
+
+#include <stdint.h>
+
+/* Reads the factory calibration once and precomputes the slopes */
+void calib_init(void);
+/* Updates the measured VDDA from a VREFINT sample, the only division left */
+void calib_set_vref(uint16_t raw_vref);
+uint16_t calib_vdda_mv(void);
+
+/* VDDA in hundredths of a volt, as shown with sct_format_dec(v, 2) */
+uint16_t calib_vdda_cv(void);
+
+/* 12-bit sample -> mV against the measured VDDA */
+uint16_t adc_to_millivolts(uint16_t raw);
+/* The same in hundredths of a volt, for sct_format_dec(v, 2) */
+uint16_t adc_to_centivolts(uint16_t raw);
+/* Internal temperature sensor sample -> hundredths of degree C */
+int16_t adc_to_centidegrees(uint16_t raw_temp);
+/* The same in tenths of a degree, for sct_format_dec(t, 1) */
+int16_t adc_to_decidegrees(uint16_t raw_temp);
+
+#endif /* CALIB_H_ */
@@ -0,0 +1,35 @@
+/*
+ * sched.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+
+#ifndef SCHED_H_
+#define SCHED_H_
+
+#include <stdint.h>
+
+/* Run-to-completion scheduler for the main loop. Tasks run from
+ * sched_run() only, never from interrupts, and must not block. */
+
+/* Millisecond time base */
+#ifndef SCHED_NOW
+#define SCHED_NOW() HAL_GetTick()
+#endif
+
+#define SCHED_MAX_TASKS 8
+
+typedef void (*sched_fn_t)(void);
+
+/* Adding a function that is already scheduled re-arms it. Returns 0 when
+ * all SCHED_MAX_TASKS slots are taken. */
+uint8_t sched_every(uint32_t ms, sched_fn_t fn);
+uint8_t sched_after(uint32_t ms, sched_fn_t fn);
+void sched_cancel(sched_fn_t fn);
+
+/* Runs every task that is due, otherwise sleeps with WFI until the next
+ * interrupt (SysTick at the latest). Call it from the main loop. */
+void sched_run(void);
+
+#endif /* SCHED_H_ */
@@ -8,9 +8,24 @@
 #ifndef SCT_H_
 #define SCT_H_
 
+/* 1 = frame shifted out by TIM16 update + DMA1 channel 3 into GPIOB->BSRR,
+ * 0 = original bit-bang through HAL_GPIO_WritePin */
+#ifndef SCT_USE_DMA
+#define SCT_USE_DMA 1
+#endif
+
 void sct_init(void);
 void sct_led(uint32_t led);
 void sct_value(uint16_t value, uint16_t led);
+/* Frame builders for sct_show(): signed decimal with dp digits after the
+ * point (out of range shows "---"), and the low 12 bits as hex */
+uint32_t sct_format_dec(int16_t value, uint8_t dp);
+uint32_t sct_format_hex(uint16_t value);
+/* Shifts the frame out only when it differs from the one on the display */
+void sct_show(uint32_t frame, uint16_t led);
+#if SCT_USE_DMA
+void sct_dma_irq(void);
+#endif
 
 
 #endif /* SCT_H_ */
@@ -0,0 +1,92 @@
+/*
+ * calib.c
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+#include <stdint.h>
+#include "calib.h"
+
+/* Temperature sensor calibration value address */
+#define TEMP110_CAL_ADDR ((uint16_t*) ((uint32_t) 0x1FFFF7C2))
+#define TEMP30_CAL_ADDR ((uint16_t*) ((uint32_t) 0x1FFFF7B8))
+/* Internal voltage reference calibration value address */
+#define VREFINT_CAL_ADDR ((uint16_t*) ((uint32_t) 0x1FFFF7BA))
+/* Factory values were taken at VDDA = 3.3 V */
+#define VDDA_CAL_MV 3300
+/* Datasheet VDDA range with some margin, other VREFINT readings are noise */
+#define VDDA_MIN_MV 2000
+#define VDDA_MAX_MV 3900
+/* Temperatures are kept in Q12 centidegrees and Q16 decidegrees, the
+ * reciprocals of the 4095 full scale in Q16 */
+#define CD_Q 12
+#define DD_Q 16
+#define RECIP_Q 16
+#define ADC_FULL 4095
+
+static int32_t temp_slope;	// centidegrees per LSB at VDDA_CAL, Q12
+static int32_t temp_slope_dd;	// decidegrees per LSB at VDDA_CAL, Q16
+static int32_t temp_off;	// 30 C at TEMP30_CAL, Q12 centidegrees
+static int32_t temp_off_dd;	// the same in Q16 decidegrees
+static int32_t temp_k;	// temp_slope rescaled to the measured VDDA
+static int32_t temp_k_dd;
+static uint32_t vref_mv_cal;	// VDDA_CAL_MV * VREFINT_CAL
+static uint32_t vdda_mv = VDDA_CAL_MV;
+static uint16_t vdda_cv = VDDA_CAL_MV / 10;
+static uint32_t mv_recip;	// VDDA / 4095 in mV, Q16
+static uint32_t cv_recip;	// VDDA / 4095 in cV, Q16
+
+/* Every division happens here, once per VDDA change */
+static void calib_update(void) {
+	vdda_cv = (vdda_mv + 5) / 10;
+	mv_recip = ((vdda_mv << RECIP_Q) + ADC_FULL / 2) / ADC_FULL;
+	cv_recip = ((vdda_mv << RECIP_Q) + ADC_FULL * 10 / 2) / (ADC_FULL * 10);
+	/* a sample at VDDA reads VDDA_CAL / VDDA times what it would at VDDA_CAL */
+	temp_k = temp_slope * (int32_t) vdda_mv / VDDA_CAL_MV;
+	temp_k_dd = temp_slope_dd * (int32_t) vdda_mv / VDDA_CAL_MV;
+}
+
+void calib_init(void) {
+	int32_t temp30_cal = *TEMP30_CAL_ADDR;
+	int32_t span = *TEMP110_CAL_ADDR - temp30_cal;
+
+	temp_slope = ((110 - 30) * 100 << CD_Q) / span;
+	temp_slope_dd = ((110 - 30) * 10 << DD_Q) / span;
+	temp_off = (30 * 100 << CD_Q) - temp30_cal * temp_slope + (1 << (CD_Q - 1));
+	temp_off_dd = (30 * 10 << DD_Q) - temp30_cal * temp_slope_dd + (1 << (DD_Q - 1));
+	vref_mv_cal = VDDA_CAL_MV * (uint32_t) (*VREFINT_CAL_ADDR);
+	vdda_mv = VDDA_CAL_MV;
+	calib_update();
+}
+
+void calib_set_vref(uint16_t raw_vref) {
+	if (raw_vref == 0) return;
+	uint32_t mv = vref_mv_cal / raw_vref;
+	if (mv < VDDA_MIN_MV || mv > VDDA_MAX_MV) return;
+	vdda_mv = mv;
+	calib_update();
+}
+
+uint16_t calib_vdda_mv(void) {
+	return vdda_mv;
+}
+
+uint16_t calib_vdda_cv(void) {
+	return vdda_cv;
+}
+
+uint16_t adc_to_millivolts(uint16_t raw) {
+	return (raw * mv_recip + (1 << (RECIP_Q - 1))) >> RECIP_Q;
+}
+
+uint16_t adc_to_centivolts(uint16_t raw) {
+	return (raw * cv_recip + (1 << (RECIP_Q - 1))) >> RECIP_Q;
+}
+
+int16_t adc_to_centidegrees(uint16_t raw_temp) {
+	return (raw_temp * temp_k + temp_off) >> CD_Q;
+}
+
+int16_t adc_to_decidegrees(uint16_t raw_temp) {
+	return (raw_temp * temp_k_dd + temp_off_dd) >> DD_Q;
+}
@@ -22,6 +22,9 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "sct.h"
+#include "filter.h"
+#include "calib.h"
+#include "sched.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -31,12 +34,15 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-#define ADC_Q 12;
-/* Temperature sensor calibration value address */
-#define TEMP110_CAL_ADDR ((uint16_t*) ((uint32_t) 0x1FFFF7C2))
-#define TEMP30_CAL_ADDR ((uint16_t*) ((uint32_t) 0x1FFFF7B8))
-/* Internal voltage reference calibration value address */
-#define VREFINT_CAL_ADDR ((uint16_t*) ((uint32_t) 0x1FFFF7BA))
+#define ADC_Q 12
+/* Scan order is CH0, TEMPSENSOR, VREFINT, so a channel is just its offset in
+ * the DMA buffer. Each half of the circular buffer holds ADC_BLOCK scans. */
+#define ADC_CHANNELS 3
+#define ADC_CH_POT 0
+#define ADC_CH_TEMP 1
+#define ADC_CH_VOLT 2
+#define ADC_BLOCK 16
+#define ADC_BUF_LEN (2 * ADC_BLOCK * ADC_CHANNELS)
 
 
 /* USER CODE END PD */
@@ -48,6 +54,7 @@
 
 /* Private variables ---------------------------------------------------------*/
 ADC_HandleTypeDef hadc;
+DMA_HandleTypeDef hdma_adc;
 
 UART_HandleTypeDef huart2;
 
@@ -55,7 +62,11 @@ UART_HandleTypeDef huart2;
 static volatile uint32_t raw_pot;
 static volatile uint32_t raw_temp;
 static volatile uint32_t raw_volt;
-static volatile uint32_t delay;
+static uint16_t adc_buf[ADC_BUF_LEN];
+static filter_ema_t pot_filter;
+static filter_ma_t temp_filter;
+static filter_median_t volt_filter;
+static enum { SHOW_POT, SHOW_VOLT, SHOW_TEMP } state = SHOW_POT;
 
 
 /* USER CODE END PV */
@@ -63,6 +74,7 @@ static volatile uint32_t delay;
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
+static void MX_DMA_Init(void);
 static void MX_USART2_UART_Init(void);
 static void MX_ADC_Init(void);
 /* USER CODE BEGIN PFP */
@@ -72,28 +84,48 @@ static void MX_ADC_Init(void);
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
 
-void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc) {
-	static uint32_t chanel = 0;
-	if (chanel == 0) {
-
-		static uint32_t avg_pot;
-		raw_pot = avg_pot >> ADC_Q;
-		avg_pot -= raw_pot;
-		avg_pot += HAL_ADC_GetValue(hadc);
-	}
-	else if (chanel == 1) {
+static void adc_process_block(const uint16_t *block) {
+	raw_pot = filter_ema_block(&pot_filter, &block[ADC_CH_POT], ADC_BLOCK, ADC_CHANNELS);
+	raw_temp = filter_ma_block(&temp_filter, &block[ADC_CH_TEMP], ADC_BLOCK, ADC_CHANNELS);
+	raw_volt = filter_median_block(&volt_filter, &block[ADC_CH_VOLT], ADC_BLOCK, ADC_CHANNELS);
+	calib_set_vref(raw_volt);
+}
 
-		raw_temp = HAL_ADC_GetValue(hadc);
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc) {
+	adc_process_block(&adc_buf[0]); // DMA is now filling the second half;
+}
 
-	}
-	else if (chanel == 2) {
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc) {
+	adc_process_block(&adc_buf[ADC_BUF_LEN / 2]); // DMA wrapped to the first half;
+}
 
-		raw_volt = HAL_ADC_GetValue(hadc);
+static void show_pot(void) {
+	state = SHOW_POT;
+}
 
+static void display_task(void) {
+	if (state==SHOW_POT){
+		uint16_t pot_cv = adc_to_centivolts(raw_pot); // pot voltage against measured VDDA;
+		sct_show(sct_format_dec(pot_cv, 2), raw_pot * 8 / 4096);
 	}
-	if (__HAL_ADC_GET_FLAG(hadc, ADC_FLAG_EOS)) chanel = 0;
-	else chanel++;
+	else if (state == SHOW_TEMP) {
+		int16_t temperature = adc_to_decidegrees(raw_temp);
+		sct_show(sct_format_dec(temperature, 1), 1);
+	}
+	else if (state == SHOW_VOLT) {
+		uint16_t voltage = calib_vdda_cv();
+		sct_show(sct_format_dec(voltage, 2), 8);
+	}
+}
 
+static void button_task(void) {
+	if (HAL_GPIO_ReadPin(GPIOC, S1_Pin) == 0) {
+		state = SHOW_TEMP;
+		sched_after(1000, show_pot); // re-armed while the button is held;
+	} else if (HAL_GPIO_ReadPin(GPIOC, S2_Pin) == 0) {
+		state = SHOW_VOLT;
+		sched_after(1000, show_pot);
+	}
 }
 /* USER CODE END 0 */
 
@@ -125,12 +157,18 @@ int main(void)
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_USART2_UART_Init();
   MX_ADC_Init();
   /* USER CODE BEGIN 2 */
+  calib_init();
+  filter_ema_init(&pot_filter, ADC_Q, 0);
+  filter_ma_init(&temp_filter, 2 * ADC_BLOCK, 0);
+  filter_median_init(&volt_filter, 5, 0);
   HAL_ADCEx_Calibration_Start(&hadc);
-  HAL_ADC_Start_IT(&hadc);
-  static enum { SHOW_POT, SHOW_VOLT, SHOW_TEMP } state = SHOW_POT;
+  HAL_ADC_Start_DMA(&hadc, (uint32_t *) adc_buf, ADC_BUF_LEN);
+  sched_every(20, display_task);
+  sched_every(20, button_task);
 
   /* USER CODE END 2 */
 
@@ -138,33 +176,7 @@ int main(void)
   /* USER CODE BEGIN WHILE */
   while (1)
   {
-
-
-		if (state==SHOW_POT){
-			sct_value(raw_pot * 500 / 4096, raw_pot * 8 / 4096);
-		}
-		else if (state == SHOW_TEMP) {
-			int32_t temperature = (raw_temp - (int32_t) (*TEMP30_CAL_ADDR));
-			temperature = temperature * (int32_t) (110 - 30);
-			temperature = temperature / (int32_t) (*TEMP110_CAL_ADDR - *TEMP30_CAL_ADDR);
-			temperature = temperature + 30;
-			sct_value(temperature, 1);
-		}
-		else if (state == SHOW_VOLT) {
-			uint32_t voltage = 330 * (*VREFINT_CAL_ADDR) / raw_volt;
-			sct_value(voltage, 8);
-		}
-		if (HAL_GPIO_ReadPin(GPIOC, S1_Pin) == 0) {
-			state = SHOW_TEMP;
-			delay = HAL_GetTick();
-		} else if (HAL_GPIO_ReadPin(GPIOC, S2_Pin) == 0) {
-			state = SHOW_VOLT;
-			delay = HAL_GetTick();
-		}
-		if (HAL_GetTick() > delay + 1000) {
-			state = SHOW_POT;
-		}
-
+		sched_run();
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
@@ -237,14 +249,14 @@ static void MX_ADC_Init(void)
   hadc.Init.Resolution = ADC_RESOLUTION_12B;
   hadc.Init.DataAlign = ADC_DATAALIGN_RIGHT;
   hadc.Init.ScanConvMode = ADC_SCAN_DIRECTION_FORWARD;
-  hadc.Init.EOCSelection = ADC_EOC_SINGLE_CONV;
+  hadc.Init.EOCSelection = ADC_EOC_SEQ_CONV;
   hadc.Init.LowPowerAutoWait = DISABLE;
   hadc.Init.LowPowerAutoPowerOff = DISABLE;
   hadc.Init.ContinuousConvMode = ENABLE;
   hadc.Init.DiscontinuousConvMode = DISABLE;
   hadc.Init.ExternalTrigConv = ADC_SOFTWARE_START;
   hadc.Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_NONE;
-  hadc.Init.DMAContinuousRequests = DISABLE;
+  hadc.Init.DMAContinuousRequests = ENABLE;
   hadc.Init.Overrun = ADC_OVR_DATA_OVERWRITTEN;
   if (HAL_ADC_Init(&hadc) != HAL_OK)
   {
@@ -317,6 +329,22 @@ static void MX_USART2_UART_Init(void)
 
 }
 
+/**
+  * Enable DMA controller clock
+  */
+static void MX_DMA_Init(void)
+{
+
+  /* DMA controller clock enable */
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  /* DMA interrupt init */
+  /* DMA1_Channel1_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+
+}
+
 /**
   * @brief GPIO Initialization Function
   * @param None
@@ -0,0 +1,47 @@
+/*
+ * cmd.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+
+#ifndef CMD_H_
+#define CMD_H_
+
+#include <stdint.h>
+
+/* Line command interpreter shared by the UART and telnet consoles. The
+ * transport provides the output sink, the project provides the table. */
+
+typedef struct {
+	void (*write)(void *ctx, const char *s, uint16_t len);
+	void *ctx;
+} cmd_sink_t;
+
+/* Parse cursor over the rest of the line, the line itself is not modified */
+typedef struct {
+	const char *p;
+} cmd_args_t;
+
+typedef void (*cmd_handler_t)(cmd_args_t *args, cmd_sink_t *out);
+
+typedef struct {
+	const char *name; // upper case, table sorted by name;
+	cmd_handler_t handler;
+} cmd_entry_t;
+
+#define CMD_COUNT(table) (sizeof(table) / sizeof((table)[0]))
+#define CMD_PRINTF_LEN 128
+
+/* Returns 0 for an unknown command, empty lines are ignored */
+uint8_t cmd_execute(const cmd_entry_t *table, uint16_t count, const char *line, cmd_sink_t *out);
+
+uint8_t cmd_next_word(cmd_args_t *args, const char **word, uint8_t *len);
+uint8_t cmd_next_uint(cmd_args_t *args, uint32_t *value); // decimal or 0x hex;
+uint8_t cmd_next_onoff(cmd_args_t *args, uint8_t *on);
+uint16_t cmd_next_hex(cmd_args_t *args, uint8_t *buf, uint16_t max); // rest of the line as hex bytes, 0 on error;
+
+void cmd_puts(cmd_sink_t *out, const char *s);
+void cmd_printf(cmd_sink_t *out, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+#endif /* CMD_H_ */
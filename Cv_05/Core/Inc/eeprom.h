@@ -0,0 +1,54 @@
+/*
+ * eeprom.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+
+#ifndef EEPROM_H_
+#define EEPROM_H_
+
+#include <stdint.h>
+#include "main.h"
+
+/* 24Cxx EEPROM with 16-bit word address. The defaults fit every part from
+ * 24C32 up; a larger page size may be set only for parts that have it. */
+#define EEPROM_I2C_ADDR 0xA0
+#ifndef EEPROM_PAGE_SIZE
+#define EEPROM_PAGE_SIZE 32
+#endif
+#ifndef EEPROM_SIZE
+#define EEPROM_SIZE 4096
+#endif
+
+/* A device in its write cycle NACKs its address, the next transfer is
+ * retried up to EEPROM_POLL_TRIES times. The first EEPROM_POLL_FAST
+ * retries go back to back, the rest 1 ms apart. */
+#define EEPROM_POLL_TRIES 20
+#define EEPROM_POLL_FAST 4
+#define EEPROM_TIMEOUT 100
+/* Interrupt driven transfers ACK-poll with zero-length writes, each one
+ * is an address byte on the bus (~0.1 ms at 100 kHz); a 5 ms write cycle
+ * takes about 50 of them */
+#define EEPROM_IT_TRIES 100
+
+typedef void (*eeprom_done_t)(HAL_StatusTypeDef status);
+
+void eeprom_init(I2C_HandleTypeDef *hi2c);
+
+/* Blocking, for the command line. HAL_BUSY while a transfer started
+ * below is running. */
+HAL_StatusTypeDef eeprom_read(uint16_t addr, uint8_t *buf, uint16_t len);
+HAL_StatusTypeDef eeprom_write(uint16_t addr, const uint8_t *buf, uint16_t len);
+HAL_StatusTypeDef eeprom_wait_ready(void);
+
+/* Interrupt driven, done() runs from the I2C interrupt and buf must stay
+ * valid until then. Every page (and a read) is preceded by an ACK poll,
+ * the next page is chained from the completion of the previous one. A
+ * write is done when its last page is accepted; its write cycle may
+ * still run, whatever comes next polls through it. */
+uint8_t eeprom_busy(void);
+HAL_StatusTypeDef eeprom_read_start(uint16_t addr, uint8_t *buf, uint16_t len, eeprom_done_t done);
+HAL_StatusTypeDef eeprom_write_start(uint16_t addr, const uint8_t *buf, uint16_t len, eeprom_done_t done);
+
+#endif /* EEPROM_H_ */
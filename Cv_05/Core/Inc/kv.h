@@ -0,0 +1,34 @@
+/*
+ * kv.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+
+#ifndef KV_H_
+#define KV_H_
+
+#include <stdint.h>
+#include "eeprom.h"
+
+/* Log structured key-value store in the upper part of the EEPROM. Values
+ * are appended to the active sector, a full sector is compacted into the
+ * next one, so writes rotate over all sectors. The first KV_BASE bytes
+ * stay free for the READ/WRITE commands. */
+#ifndef KV_BASE
+#define KV_BASE 0x0400
+#endif
+#define KV_SECTOR_SIZE 256
+#define KV_SECTORS ((EEPROM_SIZE - KV_BASE) / KV_SECTOR_SIZE)
+
+#define KV_MAX_KEYS 32
+#define KV_MAX_LEN 32
+
+/* Everything but kv_init fails with HAL_ERROR until it has succeeded */
+HAL_StatusTypeDef kv_init(void);
+uint8_t kv_ready(void);
+HAL_StatusTypeDef kv_get(uint8_t key, void *buf, uint8_t size, uint8_t *len);
+HAL_StatusTypeDef kv_set(uint8_t key, const void *buf, uint8_t len);
+HAL_StatusTypeDef kv_delete(uint8_t key);
+
+#endif /* KV_H_ */
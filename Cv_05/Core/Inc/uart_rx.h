@@ -0,0 +1,39 @@
+/*
+ * uart_rx.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+
+#ifndef UART_RX_H_
+#define UART_RX_H_
+
+#include <stdint.h>
+
+/* Console input: HAL_UARTEx_ReceiveToIdle_DMA() fills uart_rx_buf in
+ * circular mode. The UART callbacks only publish the DMA position or flag
+ * a restart; read_ptr and the line being assembled belong to the main
+ * loop, which drains the buffer in at most two spans per pass. */
+#ifndef UART_RX_BUF_LEN
+#define UART_RX_BUF_LEN 64
+#endif
+#ifndef UART_RX_LINE_LEN
+#define UART_RX_LINE_LEN 256
+#endif
+
+typedef void (*uart_rx_line_fn)(char *line);
+
+extern uint8_t uart_rx_buf[UART_RX_BUF_LEN];
+
+void uart_rx_init(uart_rx_line_fn line);
+/* From HAL_UARTEx_RxEventCallback(): DMA position after IDLE/HT/TC */
+void uart_rx_event(uint16_t size);
+/* From HAL_UART_ErrorCallback(), before the DMA is started again at 0 */
+void uart_rx_restart(void);
+/* Main loop: hands complete lines to the callback, returns 1 when the
+ * buffer is drained and the loop may sleep */
+uint8_t uart_rx_poll(void);
+/* Line assembly over one contiguous span of received bytes */
+void uart_rx_span(const uint8_t *span, uint16_t len);
+
+#endif /* UART_RX_H_ */
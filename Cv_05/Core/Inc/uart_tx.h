@@ -0,0 +1,40 @@
+/*
+ * uart_tx.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+
+#ifndef UART_TX_H_
+#define UART_TX_H_
+
+#include <stdint.h>
+#include "main.h"
+
+/* stdout ring drained by DMA, _write() only copies into it */
+#define UART_TX_USART       USART2
+#define UART_TX_DMA         DMA1_Channel4
+#define UART_TX_DMA_IRQn    DMA1_Channel4_5_IRQn
+#define UART_TX_DMA_TCIF    DMA_ISR_TCIF4
+#define UART_TX_DMA_CLEAR   (DMA_IFCR_CGIF4 | DMA_IFCR_CTCIF4 | DMA_IFCR_CHTIF4 | DMA_IFCR_CTEIF4)
+
+#ifndef UART_TX_BUF_LEN
+#define UART_TX_BUF_LEN 512
+#endif
+
+/* What uart_tx_write() does when the ring is full */
+#define UART_TX_BLOCK       0 // wait for the DMA to make room;
+#define UART_TX_DROP        1 // keep what fits, drop the rest;
+#define UART_TX_OVERWRITE   2 // drop the oldest bytes not yet handed to the DMA;
+
+#ifndef UART_TX_POLICY
+#define UART_TX_POLICY UART_TX_BLOCK
+#endif
+
+void uart_tx_init(void);
+uint16_t uart_tx_write(const uint8_t *buf, uint16_t n);
+void uart_tx_flush(void);
+uint32_t uart_tx_dropped(void);
+void uart_tx_irq(void);
+
+#endif /* UART_TX_H_ */
@@ -0,0 +1,133 @@
+/*
+ * cmd.c
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "cmd.h"
+
+static char cmd_upper(char c) {
+	return (c >= 'a' && c <= 'z') ? c - 'a' + 'A' : c;
+}
+
+/* strcasecmp of a word that is not zero terminated against a table name */
+static int cmd_compare(const char *word, uint8_t len, const char *name) {
+	for (uint8_t i = 0; i < len; i++) {
+		char c = cmd_upper(word[i]);
+		if (c != name[i]) return (uint8_t) c - (uint8_t) name[i]; // also ends on name's terminator;
+	}
+	return name[len] ? -1 : 0;
+}
+
+uint8_t cmd_next_word(cmd_args_t *args, const char **word, uint8_t *len) {
+	const char *p = args->p;
+
+	while (*p == ' ') p++;
+	*word = p;
+	while (*p && *p != ' ') p++;
+	args->p = p;
+	*len = p - *word;
+	return *len != 0;
+}
+
+uint8_t cmd_next_uint(cmd_args_t *args, uint32_t *value) {
+	const char *word;
+	uint8_t len, i = 0, base = 10;
+	uint32_t v = 0;
+
+	if (!cmd_next_word(args, &word, &len)) return 0;
+	if (len > 2 && word[0] == '0' && cmd_upper(word[1]) == 'X') {
+		base = 16;
+		i = 2;
+	}
+	for (; i < len; i++) {
+		char c = cmd_upper(word[i]);
+		uint8_t d;
+		if (c >= '0' && c <= '9') d = c - '0';
+		else if (base == 16 && c >= 'A' && c <= 'F') d = c - 'A' + 10;
+		else return 0;
+		if (v > (UINT32_MAX - d) / base) return 0; // would not fit in 32 bits;
+		v = v * base + d;
+	}
+	*value = v;
+	return 1;
+}
+
+uint8_t cmd_next_onoff(cmd_args_t *args, uint8_t *on) {
+	const char *word;
+	uint8_t len;
+
+	if (!cmd_next_word(args, &word, &len)) return 0;
+	if (cmd_compare(word, len, "ON") == 0) {
+		*on = 1;
+	} else if (cmd_compare(word, len, "OFF") == 0) {
+		*on = 0;
+	} else {
+		return 0;
+	}
+	return 1;
+}
+
+static int8_t cmd_hex_digit(char c) {
+	c = cmd_upper(c);
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+uint16_t cmd_next_hex(cmd_args_t *args, uint8_t *buf, uint16_t max) {
+	const char *word;
+	uint8_t len;
+	uint16_t n = 0;
+
+	while (cmd_next_word(args, &word, &len)) {
+		if (len & 1) return 0; // whole bytes only;
+		for (uint8_t i = 0; i < len; i += 2) {
+			int8_t hi = cmd_hex_digit(word[i]);
+			int8_t lo = cmd_hex_digit(word[i + 1]);
+			if (hi < 0 || lo < 0 || n >= max) return 0;
+			buf[n++] = (hi << 4) | lo;
+		}
+	}
+	return n;
+}
+
+void cmd_puts(cmd_sink_t *out, const char *s) {
+	out->write(out->ctx, s, strlen(s));
+}
+
+void cmd_printf(cmd_sink_t *out, const char *fmt, ...) {
+	char s[CMD_PRINTF_LEN];
+	va_list ap;
+	int len;
+
+	va_start(ap, fmt);
+	len = vsnprintf(s, sizeof(s), fmt, ap);
+	va_end(ap);
+	if (len < 0) return;
+	if (len >= (int) sizeof(s)) len = sizeof(s) - 1;
+	out->write(out->ctx, s, len);
+}
+
+uint8_t cmd_execute(const cmd_entry_t *table, uint16_t count, const char *line, cmd_sink_t *out) {
+	cmd_args_t args = { line };
+	const char *word;
+	uint8_t len;
+	uint16_t lo = 0, hi = count;
+
+	if (!cmd_next_word(&args, &word, &len)) return 1;
+	while (lo < hi) { // binary search, the table is sorted;
+		uint16_t mid = (lo + hi) / 2;
+		int c = cmd_compare(word, len, table[mid].name);
+		if (c == 0) {
+			table[mid].handler(&args, out);
+			return 1;
+		}
+		if (c < 0) hi = mid;
+		else lo = mid + 1;
+	}
+	return 0;
+}
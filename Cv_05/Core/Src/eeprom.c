@@ -0,0 +1,170 @@
+/*
+ * eeprom.c
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+#include "eeprom.h"
+
+static I2C_HandleTypeDef *ee_i2c;
+
+/* Interrupt driven transfer: EE_PROBE is the ACK poll in front of every
+ * EE_XFER (one page of a write, or the whole read) */
+enum {
+	EE_PROBE,
+	EE_XFER,
+};
+
+static struct {
+	uint8_t *buf;
+	uint16_t addr;
+	uint16_t len;
+	uint16_t chunk;
+	uint8_t write;
+	uint8_t step;
+	uint8_t tries;
+	uint8_t dummy;
+	volatile uint8_t busy;
+	eeprom_done_t done;
+} ee;
+
+/* Largest write starting at addr that stays inside one page */
+static uint16_t eeprom_chunk(uint16_t addr, uint16_t len) {
+	uint16_t room = EEPROM_PAGE_SIZE - (addr % EEPROM_PAGE_SIZE);
+	return (len < room) ? len : room;
+}
+
+void eeprom_init(I2C_HandleTypeDef *hi2c) {
+	ee_i2c = hi2c;
+}
+
+HAL_StatusTypeDef eeprom_wait_ready(void) {
+	for (uint8_t tries = 0; tries < EEPROM_POLL_TRIES; tries++) {
+		if (HAL_I2C_IsDeviceReady(ee_i2c, EEPROM_I2C_ADDR, 1, EEPROM_TIMEOUT) == HAL_OK)
+			return HAL_OK;
+		if (tries >= EEPROM_POLL_FAST)
+			HAL_Delay(1);
+	}
+	return HAL_TIMEOUT;
+}
+
+HAL_StatusTypeDef eeprom_read(uint16_t addr, uint8_t *buf, uint16_t len) {
+	if (len > EEPROM_SIZE || addr > EEPROM_SIZE - len) return HAL_ERROR;
+	if (ee.busy) return HAL_BUSY;
+	if (eeprom_wait_ready() != HAL_OK) return HAL_TIMEOUT;
+	return HAL_I2C_Mem_Read(ee_i2c, EEPROM_I2C_ADDR, addr, I2C_MEMADD_SIZE_16BIT,
+			buf, len, EEPROM_TIMEOUT + len);
+}
+
+HAL_StatusTypeDef eeprom_write(uint16_t addr, const uint8_t *buf, uint16_t len) {
+	if (len > EEPROM_SIZE || addr > EEPROM_SIZE - len) return HAL_ERROR;
+	if (ee.busy) return HAL_BUSY;
+	while (len) {
+		uint16_t chunk = eeprom_chunk(addr, len);
+		HAL_StatusTypeDef status;
+
+		if (eeprom_wait_ready() != HAL_OK) return HAL_TIMEOUT;
+		status = HAL_I2C_Mem_Write(ee_i2c, EEPROM_I2C_ADDR, addr, I2C_MEMADD_SIZE_16BIT,
+				(uint8_t*) buf, chunk, EEPROM_TIMEOUT);
+		if (status != HAL_OK) return status;
+		addr += chunk;
+		buf += chunk;
+		len -= chunk;
+	}
+	return eeprom_wait_ready();
+}
+
+uint8_t eeprom_busy(void) {
+	return ee.busy;
+}
+
+/* Zero-length write, the address byte alone: ACK ends in MasterTxCplt,
+ * NACK (write cycle still running) in ErrorCallback with AF */
+static HAL_StatusTypeDef eeprom_probe(void) {
+	ee.step = EE_PROBE;
+	return HAL_I2C_Master_Transmit_IT(ee_i2c, EEPROM_I2C_ADDR, &ee.dummy, 0);
+}
+
+/* The device just ACKed, so the address phase Mem_*_IT sends blocking
+ * goes through at once */
+static HAL_StatusTypeDef eeprom_xfer(void) {
+	ee.step = EE_XFER;
+	if (ee.write) {
+		ee.chunk = eeprom_chunk(ee.addr, ee.len);
+		return HAL_I2C_Mem_Write_IT(ee_i2c, EEPROM_I2C_ADDR, ee.addr, I2C_MEMADD_SIZE_16BIT,
+				ee.buf, ee.chunk);
+	}
+	ee.chunk = ee.len; // one sequential read;
+	return HAL_I2C_Mem_Read_IT(ee_i2c, EEPROM_I2C_ADDR, ee.addr, I2C_MEMADD_SIZE_16BIT,
+			ee.buf, ee.chunk);
+}
+
+static void eeprom_finish(HAL_StatusTypeDef status) {
+	ee.busy = 0;
+	if (ee.done != NULL)
+		ee.done(status);
+}
+
+static HAL_StatusTypeDef eeprom_start(uint16_t addr, uint8_t *buf, uint16_t len, uint8_t write,
+		eeprom_done_t done) {
+	HAL_StatusTypeDef status;
+
+	if (len == 0 || len > EEPROM_SIZE || addr > EEPROM_SIZE - len) return HAL_ERROR;
+	if (ee.busy) return HAL_BUSY;
+	ee.busy = 1;
+	ee.addr = addr;
+	ee.buf = buf;
+	ee.len = len;
+	ee.write = write;
+	ee.tries = 0;
+	ee.done = done;
+	status = eeprom_probe();
+	if (status != HAL_OK)
+		ee.busy = 0;
+	return status;
+}
+
+HAL_StatusTypeDef eeprom_read_start(uint16_t addr, uint8_t *buf, uint16_t len, eeprom_done_t done) {
+	return eeprom_start(addr, buf, len, 0, done);
+}
+
+HAL_StatusTypeDef eeprom_write_start(uint16_t addr, const uint8_t *buf, uint16_t len, eeprom_done_t done) {
+	return eeprom_start(addr, (uint8_t*) buf, len, 1, done);
+}
+
+static void eeprom_chunk_done(void) {
+	ee.addr += ee.chunk;
+	ee.buf += ee.chunk;
+	ee.len -= ee.chunk;
+	if (ee.len == 0) {
+		eeprom_finish(HAL_OK);
+		return;
+	}
+	ee.tries = 0;
+	if (eeprom_probe() != HAL_OK) // next page once this one is written;
+		eeprom_finish(HAL_ERROR);
+}
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+	if (hi2c != ee_i2c || !ee.busy || ee.step != EE_PROBE) return;
+	if (eeprom_xfer() != HAL_OK)
+		eeprom_finish(HAL_ERROR);
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+	if (hi2c == ee_i2c && ee.busy)
+		eeprom_chunk_done();
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c) {
+	if (hi2c == ee_i2c && ee.busy)
+		eeprom_chunk_done();
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+	if (hi2c != ee_i2c || !ee.busy) return;
+	if (ee.step == EE_PROBE && (HAL_I2C_GetError(hi2c) & HAL_I2C_ERROR_AF)
+			&& ++ee.tries < EEPROM_IT_TRIES && eeprom_probe() == HAL_OK)
+		return; // still in its write cycle, poll again;
+	eeprom_finish(HAL_ERROR);
+}
@@ -0,0 +1,176 @@
+/*
+ * kv.c
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+#include <string.h>
+#include "kv.h"
+
+/* Sector: header, records, 0xFF terminator, stale bytes of older rounds.
+ * Header: magic (2), sequence number (2), crc (1). The valid header with
+ * the highest sequence number marks the active sector; it is written only
+ * after the compacted records, so an interrupted compaction is ignored.
+ * Record: key, len, data, crc over all of them. An append writes the new
+ * terminator first and then the record over the old one, so scanning
+ * stops at the terminator or at the bad crc of a torn append and never
+ * reaches stale bytes. */
+#define KV_MAGIC 0x4B56
+#define KV_HDR_LEN 5
+#define KV_REC_LEN(len) (3 + (len))
+#define KV_END 0xFF
+
+static uint8_t kv_ok; // kv_init found or made a valid sector;
+static uint8_t kv_sector; // active sector;
+static uint16_t kv_seq;
+static uint16_t kv_end; // offset of the terminator in the active sector;
+static uint16_t kv_index[KV_MAX_KEYS]; // record offset, 0 when the key is not set;
+static uint8_t kv_buf[KV_SECTOR_SIZE];
+
+static uint8_t kv_crc(const uint8_t *p, uint16_t len) {
+	uint8_t crc = 0;
+	while (len--) {
+		crc ^= *p++;
+		for (uint8_t i = 0; i < 8; i++)
+			crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+	}
+	return crc;
+}
+
+static uint16_t kv_addr(uint8_t sector, uint16_t offset) {
+	return KV_BASE + sector * KV_SECTOR_SIZE + offset;
+}
+
+/* Builds the index from a sector image in kv_buf */
+static void kv_scan(void) {
+	uint16_t pos = KV_HDR_LEN;
+
+	memset(kv_index, 0, sizeof(kv_index));
+	while (pos + KV_REC_LEN(0) <= KV_SECTOR_SIZE - 1) {
+		uint8_t key = kv_buf[pos];
+		uint8_t len = kv_buf[pos + 1];
+
+		if (key == KV_END || key >= KV_MAX_KEYS || len > KV_MAX_LEN) break;
+		if (pos + KV_REC_LEN(len) > KV_SECTOR_SIZE - 1) break;
+		if (kv_crc(&kv_buf[pos], 2 + len) != kv_buf[pos + 2 + len]) break;
+		kv_index[key] = len ? pos : 0; // empty value deletes the key;
+		pos += KV_REC_LEN(len);
+	}
+	kv_end = pos;
+}
+
+static uint16_t kv_put_record(uint8_t *dst, uint8_t key, const uint8_t *data, uint8_t len) {
+	dst[0] = key;
+	dst[1] = len;
+	memcpy(&dst[2], data, len);
+	dst[2 + len] = kv_crc(dst, 2 + len);
+	return KV_REC_LEN(len);
+}
+
+/* Copies live records plus the new one into the next sector, then makes
+ * it active by writing its header */
+static HAL_StatusTypeDef kv_compact(uint8_t key, const uint8_t *data, uint8_t len) {
+	static uint8_t image[KV_SECTOR_SIZE];
+	uint8_t next = (kv_sector + 1) % KV_SECTORS;
+	uint16_t pos = KV_HDR_LEN;
+	HAL_StatusTypeDef status;
+
+	if (eeprom_read(kv_addr(kv_sector, 0), kv_buf, KV_SECTOR_SIZE) != HAL_OK) return HAL_ERROR;
+	for (uint8_t k = 0; k < KV_MAX_KEYS; k++) {
+		uint16_t rec = kv_index[k];
+		if (k == key || rec == 0) continue;
+		pos += kv_put_record(&image[pos], k, &kv_buf[rec + 2], kv_buf[rec + 1]);
+	}
+	if (len) {
+		if (pos + KV_REC_LEN(len) > KV_SECTOR_SIZE - 1) return HAL_ERROR; // store is full;
+		pos += kv_put_record(&image[pos], key, data, len);
+	}
+	image[pos] = KV_END;
+
+	status = eeprom_write(kv_addr(next, KV_HDR_LEN), &image[KV_HDR_LEN], pos + 1 - KV_HDR_LEN);
+	if (status != HAL_OK) return status;
+
+	kv_seq++;
+	image[0] = KV_MAGIC >> 8;
+	image[1] = KV_MAGIC & 0xFF;
+	image[2] = kv_seq >> 8;
+	image[3] = kv_seq & 0xFF;
+	image[4] = kv_crc(image, 4);
+	status = eeprom_write(kv_addr(next, 0), image, KV_HDR_LEN);
+	if (status != HAL_OK) return status;
+
+	kv_sector = next;
+	memcpy(kv_buf, image, pos + 1);
+	kv_scan();
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef kv_init(void) {
+	uint8_t hdr[KV_HDR_LEN];
+	uint8_t found = 0;
+
+	kv_ok = 0;
+	for (uint8_t s = 0; s < KV_SECTORS; s++) {
+		if (eeprom_read(kv_addr(s, 0), hdr, KV_HDR_LEN) != HAL_OK) return HAL_ERROR;
+		if (((hdr[0] << 8) | hdr[1]) != KV_MAGIC || kv_crc(hdr, 4) != hdr[4]) continue;
+		uint16_t seq = (hdr[2] << 8) | hdr[3];
+		if (!found || (int16_t)(seq - kv_seq) > 0) {
+			kv_sector = s;
+			kv_seq = seq;
+			found = 1;
+		}
+	}
+
+	if (!found) { // blank part, start with an empty store;
+		memset(kv_index, 0, sizeof(kv_index));
+		kv_sector = KV_SECTORS - 1;
+		kv_seq = 0;
+		if (kv_compact(KV_END, NULL, 0) != HAL_OK) return HAL_ERROR;
+		kv_ok = 1;
+		return HAL_OK;
+	}
+	if (eeprom_read(kv_addr(kv_sector, 0), kv_buf, KV_SECTOR_SIZE) != HAL_OK) return HAL_ERROR;
+	kv_scan();
+	kv_ok = 1;
+	return HAL_OK;
+}
+
+uint8_t kv_ready(void) {
+	return kv_ok;
+}
+
+HAL_StatusTypeDef kv_get(uint8_t key, void *buf, uint8_t size, uint8_t *len) {
+	uint8_t rec[2];
+	uint16_t pos;
+
+	if (!kv_ok || key >= KV_MAX_KEYS || (pos = kv_index[key]) == 0) return HAL_ERROR;
+	if (eeprom_read(kv_addr(kv_sector, pos), rec, 2) != HAL_OK) return HAL_ERROR;
+	*len = rec[1];
+	if (size > rec[1]) size = rec[1];
+	return eeprom_read(kv_addr(kv_sector, pos + 2), buf, size);
+}
+
+HAL_StatusTypeDef kv_set(uint8_t key, const void *buf, uint8_t len) {
+	uint8_t rec[KV_REC_LEN(KV_MAX_LEN)];
+	uint8_t end = KV_END;
+	uint16_t n;
+	HAL_StatusTypeDef status;
+
+	if (!kv_ok || key >= KV_MAX_KEYS || len > KV_MAX_LEN) return HAL_ERROR;
+	if (len == 0 && kv_index[key] == 0) return HAL_OK;
+	if (kv_end + KV_REC_LEN(len) > KV_SECTOR_SIZE - 1)
+		return kv_compact(key, buf, len);
+
+	n = kv_put_record(rec, key, buf, len);
+	status = eeprom_write(kv_addr(kv_sector, kv_end + n), &end, 1);
+	if (status != HAL_OK) return status;
+	status = eeprom_write(kv_addr(kv_sector, kv_end), rec, n);
+	if (status != HAL_OK) return status;
+	kv_index[key] = len ? kv_end : 0;
+	kv_end += n;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef kv_delete(uint8_t key) {
+	return kv_set(key, NULL, 0);
+}
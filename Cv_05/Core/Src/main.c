@@ -24,6 +24,11 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include "uart_tx.h"
+#include "uart_rx.h"
+#include "cmd.h"
+#include "eeprom.h"
+#include "kv.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -33,10 +38,7 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-#define RX_BUFFER_LEN 64
-#define CMD_BUFFER_LEN 256
-#define EEPROM_ADDR 0xA0
-#define uart_rx_write_ptr (RX_BUFFER_LEN - hdma_usart2_rx.Instance->CNDTR)
+#define EEPROM_CHUNK 64
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -51,8 +53,7 @@ UART_HandleTypeDef huart2;
 DMA_HandleTypeDef hdma_usart2_rx;
 
 /* USER CODE BEGIN PV */
-static uint8_t uart_rx_buf[RX_BUFFER_LEN];
-static volatile uint16_t uart_rx_read_ptr = 0;
+
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -69,91 +70,185 @@ static void MX_I2C1_Init(void);
 /* USER CODE BEGIN 0 */
 int _write(int file, char const *buf, int n) {
 	/* stdout redirection to UART2 */
-	HAL_UART_Transmit(&huart2, (uint8_t*) (buf), n, HAL_MAX_DELAY);
+	uart_tx_write((const uint8_t*) buf, n);
 	return n;
 }
 
-void uart_process_command(char *cmd) {
-
-	char *token;
-	token = strtok(cmd, " ");
-	if (strcasecmp(token, "HELLO") == 0) {
-		printf("Komunikace OK\n");
+static void cmd_hello(cmd_args_t *args, cmd_sink_t *out) {
+	cmd_puts(out, "Komunikace OK\n");
+}
 
-	} else if (strcasecmp(token, "LED1") == 0) {
+static void cmd_led1(cmd_args_t *args, cmd_sink_t *out) {
+	uint8_t on;
+	if (cmd_next_onoff(args, &on))
+		HAL_GPIO_WritePin(GPIOA, LED1_Pin, on);
+	cmd_puts(out, "OK\n");
+}
 
-		token = strtok(NULL, " ");
-		if (strcasecmp(token, "ON") == 0) {
+static void cmd_led2(cmd_args_t *args, cmd_sink_t *out) {
+	uint8_t on;
+	if (cmd_next_onoff(args, &on))
+		HAL_GPIO_WritePin(GPIOB, LED2_Pin, on);
+	cmd_puts(out, "OK\n");
+}
 
-			HAL_GPIO_WritePin(GPIOA, LED1_Pin, 1);
-		} else if (strcasecmp(token, "OFF") == 0) {
-			HAL_GPIO_WritePin(GPIOA, LED1_Pin, 0);
-		}
-		printf("OK\n");
-	} else if (strcasecmp(token, "LED2") == 0) {
+static void cmd_status(cmd_args_t *args, cmd_sink_t *out) {
+	if (HAL_GPIO_ReadPin(GPIOA, LED1_Pin) == 0) {
+		cmd_puts(out, "LED1 is OFF\n");
+	} else {
+		cmd_puts(out, "LED1 is ON\n");
+	}
+	if (HAL_GPIO_ReadPin(GPIOB, LED2_Pin) == 0) {
+		cmd_puts(out, "LED2 is OFF\n");
+	} else {
+		cmd_puts(out, "LED2 is ON\n");
+	}
+}
 
-		token = strtok(NULL, " ");
-		if (strcasecmp(token, "ON") == 0) {
+/* Prints len bytes from addr, 16 per line, reading EEPROM_CHUNK at a time */
+static void eeprom_print(cmd_sink_t *out, uint16_t addr, uint16_t len) {
+	uint8_t buf[EEPROM_CHUNK];
 
-			HAL_GPIO_WritePin(GPIOB, LED2_Pin, 1);
-		} else if (strcasecmp(token, "OFF") == 0) {
-			HAL_GPIO_WritePin(GPIOB, LED2_Pin, 0);
-		}
-		printf("OK\n");
-	} else if (strcasecmp(token, "STATUS") == 0) {
-		if (HAL_GPIO_ReadPin(GPIOA, LED1_Pin) == 0) {
-			printf("LED1 is OFF\n");
-		} else {
-			printf("LED1 is ON\n");
+	while (len) {
+		uint16_t chunk = (len < EEPROM_CHUNK) ? len : EEPROM_CHUNK;
+		if (eeprom_read(addr, buf, chunk) != HAL_OK) {
+			cmd_puts(out, "ERROR\n");
+			return;
 		}
-		if (HAL_GPIO_ReadPin(GPIOB, LED2_Pin) == 0) {
-			printf("LED2 is OFF\n");
-		} else {
-			printf("LED2 is ON\n");
+		for (uint16_t i = 0; i < chunk; i++) {
+			if ((i % 16) == 0)
+				cmd_printf(out, "%04X:", addr + i);
+			cmd_printf(out, " %02X", buf[i]);
+			if ((i % 16) == 15 || i == chunk - 1)
+				cmd_puts(out, "\n");
 		}
+		addr += chunk;
+		len -= chunk;
+	}
+}
+
+static void cmd_read(cmd_args_t *args, cmd_sink_t *out) {
+	uint32_t addr = 0, len = 1;
 
-	} else if (strcasecmp(token, "READ") == 0) {
-		token = strtok(NULL, " ");
-		uint16_t addr = atoi(token);
+	cmd_next_uint(args, &addr);
+	cmd_next_uint(args, &len);
+	if (len > EEPROM_SIZE || addr > EEPROM_SIZE - len) {
+		cmd_puts(out, "ERROR\n");
+		return;
+	}
+	if (len == 1) {
 		uint8_t value = 0;
+		eeprom_read(addr, &value, 1);
+		cmd_printf(out, "Adresa 0x%04x = 0x%02X\n", (uint16_t) addr, value);
+		return;
+	}
+	eeprom_print(out, addr, len);
+}
 
-		HAL_I2C_Mem_Read(&hi2c1, EEPROM_ADDR, addr, I2C_MEMADD_SIZE_16BIT,
-				&value, 1, 1000);
-		printf("Adresa 0x%04x = 0x%02X\n", addr, value);
-	} else if (strcasecmp(token, "WRITE") == 0) {
-		token = strtok(NULL, " ");
-		uint16_t addr = atoi(token);
-		token = strtok(NULL, " ");
-		uint8_t value = atoi(token);
-		HAL_I2C_Mem_Write(&hi2c1, EEPROM_ADDR, addr, I2C_MEMADD_SIZE_16BIT,
-				&value, 1, 1000);
-		while (HAL_I2C_IsDeviceReady(&hi2c1, EEPROM_ADDR, 300, 1000)
-				== HAL_TIMEOUT) {
-		}
-		printf("OK\n");
-	} else if (strcasecmp(token, "DUMP") == 0) {
-		for (uint8_t i = 0; i < 16; i++) {
-			uint8_t value = 0;
-			HAL_I2C_Mem_Read(&hi2c1, EEPROM_ADDR, i, I2C_MEMADD_SIZE_16BIT,
-					&value, 1, 1000);
-			printf("%02X ", value);
-			if ((i % 8) == 7)
-				printf("\n");
-		}
-		printf("\n");
+static void cmd_write(cmd_args_t *args, cmd_sink_t *out) {
+	uint32_t addr = 0;
+	uint8_t data[EEPROM_CHUNK];
+	uint16_t len;
+
+	cmd_next_uint(args, &addr);
+	len = cmd_next_hex(args, data, sizeof(data));
+	if (len == 0 || addr > KV_BASE - len || eeprom_write(addr, data, len) != HAL_OK) { // the store owns KV_BASE and up;
+		cmd_puts(out, "ERROR\n");
+		return;
 	}
+	cmd_puts(out, "OK\n");
 }
-void uart_byte_available(uint8_t c) {
-	static uint16_t cnt;
-	static char data[CMD_BUFFER_LEN];
-	if (cnt < CMD_BUFFER_LEN && c >= ' ' && c <= '~')
-		data[cnt++] = c;
-	if ((c == '\n' || c == '\r') && cnt > 0) {
-		data[cnt] = '\0';
-		uart_process_command(data);
-		cnt = 0;
+
+static void cmd_dump(cmd_args_t *args, cmd_sink_t *out) {
+	eeprom_print(out, 0, 16);
+}
+
+/* The store may have been missing at startup, try again before giving up */
+static uint8_t kv_check(cmd_sink_t *out) {
+	if (kv_ready() || kv_init() == HAL_OK)
+		return 1;
+	cmd_puts(out, "ERROR\n");
+	return 0;
+}
+
+static void cmd_get(cmd_args_t *args, cmd_sink_t *out) {
+	uint32_t key = 0;
+	uint8_t value[KV_MAX_LEN], len;
+
+	if (!kv_check(out))
+		return;
+	if (!cmd_next_uint(args, &key) || key >= KV_MAX_KEYS
+			|| kv_get(key, value, sizeof(value), &len) != HAL_OK) {
+		cmd_puts(out, "NONE\n");
+		return;
+	}
+	for (uint8_t i = 0; i < len; i++)
+		cmd_printf(out, "%02X", value[i]);
+	cmd_puts(out, "\n");
+}
+
+static void cmd_set(cmd_args_t *args, cmd_sink_t *out) {
+	uint32_t key = 0;
+	uint8_t value[KV_MAX_LEN];
+	uint16_t len;
+
+	if (!kv_check(out))
+		return;
+	if (!cmd_next_uint(args, &key) || key >= KV_MAX_KEYS
+			|| (len = cmd_next_hex(args, value, sizeof(value))) == 0 // missing or bad value;
+			|| kv_set(key, value, len) != HAL_OK) {
+		cmd_puts(out, "ERROR\n");
+		return;
 	}
+	cmd_puts(out, "OK\n");
+}
+
+static void cmd_del(cmd_args_t *args, cmd_sink_t *out) {
+	uint32_t key = 0;
+
+	if (!kv_check(out))
+		return;
+	if (!cmd_next_uint(args, &key) || key >= KV_MAX_KEYS || kv_delete(key) != HAL_OK) {
+		cmd_puts(out, "ERROR\n");
+		return;
+	}
+	cmd_puts(out, "OK\n");
+}
 
+static const cmd_entry_t uart_commands[] = { // keep sorted by name;
+	{ "DEL", cmd_del },
+	{ "DUMP", cmd_dump },
+	{ "GET", cmd_get },
+	{ "HELLO", cmd_hello },
+	{ "LED1", cmd_led1 },
+	{ "LED2", cmd_led2 },
+	{ "READ", cmd_read },
+	{ "SET", cmd_set },
+	{ "STATUS", cmd_status },
+	{ "WRITE", cmd_write },
+};
+
+static void uart_sink_write(void *ctx, const char *s, uint16_t len) {
+	uart_tx_write((const uint8_t*) s, len);
+}
+
+static cmd_sink_t uart_sink = { uart_sink_write, NULL };
+
+void uart_process_command(char *cmd) {
+	cmd_execute(uart_commands, CMD_COUNT(uart_commands), cmd, &uart_sink);
+}
+
+static void uart_rx_start(void) {
+	HAL_UARTEx_ReceiveToIdle_DMA(&huart2, uart_rx_buf, UART_RX_BUF_LEN);
+}
+
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) {
+	uart_rx_event(Size);
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+	uart_rx_restart(); // overrun stops the DMA, start over;
+	uart_rx_start();
 }
 /* USER CODE END 0 */
 
@@ -188,18 +283,18 @@ int main(void) {
 	MX_USART2_UART_Init();
 	MX_I2C1_Init();
 	/* USER CODE BEGIN 2 */
-	HAL_UART_Receive_DMA(&huart2, uart_rx_buf, RX_BUFFER_LEN);
+	uart_tx_init();
+	eeprom_init(&hi2c1);
+	kv_init(); // GET/SET/DEL retry it while it fails;
+	uart_rx_init(uart_process_command);
+	uart_rx_start();
 	/* USER CODE END 2 */
 
 	/* Infinite loop */
 	/* USER CODE BEGIN WHILE */
 	while (1) {
-		while (uart_rx_read_ptr != uart_rx_write_ptr) {
-			uint8_t b = uart_rx_buf[uart_rx_read_ptr];
-			if (++uart_rx_read_ptr >= RX_BUFFER_LEN)
-				uart_rx_read_ptr = 0; // increase read pointer
-			uart_byte_available(b); // process every received byte with the RX state machine
-		}
+		if (uart_rx_poll())
+			__WFI(); // sleep until the next UART/DMA event or tick;
 		/* USER CODE END WHILE */
 
 		/* USER CODE BEGIN 3 */
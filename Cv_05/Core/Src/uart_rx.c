@@ -0,0 +1,69 @@
+/*
+ * uart_rx.c
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+#include "uart_rx.h"
+#include "main.h"
+
+uint8_t uart_rx_buf[UART_RX_BUF_LEN];
+static volatile uint16_t uart_rx_write_ptr; // DMA position at the last IDLE/HT/TC event;
+static volatile uint8_t uart_rx_restarted;
+static uint16_t uart_rx_read_ptr;
+static char uart_rx_line[UART_RX_LINE_LEN + 1];
+static uint16_t uart_rx_cnt;
+static uart_rx_line_fn uart_rx_handler;
+
+void uart_rx_init(uart_rx_line_fn line) {
+	uart_rx_handler = line;
+	uart_rx_read_ptr = 0;
+	uart_rx_write_ptr = 0;
+	uart_rx_restarted = 0;
+	uart_rx_cnt = 0;
+}
+
+void uart_rx_event(uint16_t size) {
+	uart_rx_write_ptr = (size >= UART_RX_BUF_LEN) ? 0 : size; // line went idle or DMA hit half/end;
+}
+
+void uart_rx_restart(void) {
+	uart_rx_write_ptr = 0;
+	uart_rx_restarted = 1; // read_ptr is reset by the main loop;
+}
+
+void uart_rx_span(const uint8_t *span, uint16_t len) {
+	for (uint16_t i = 0; i < len; i++) {
+		uint8_t c = span[i];
+		if (uart_rx_cnt < UART_RX_LINE_LEN && c >= ' ' && c <= '~')
+			uart_rx_line[uart_rx_cnt++] = c;
+		if ((c == '\n' || c == '\r') && uart_rx_cnt > 0) {
+			uart_rx_line[uart_rx_cnt] = '\0';
+			uart_rx_cnt = 0;
+			uart_rx_handler(uart_rx_line);
+		}
+	}
+}
+
+uint8_t uart_rx_poll(void) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq(); // write_ptr and the restart flag as one snapshot;
+	uint16_t write_ptr = uart_rx_write_ptr;
+	uint8_t restarted = uart_rx_restarted;
+	uart_rx_restarted = 0;
+	__set_PRIMASK(primask);
+
+	if (restarted) { // overrun lost bytes, drop the partial line too;
+		uart_rx_read_ptr = 0;
+		uart_rx_cnt = 0;
+	}
+	if (write_ptr < uart_rx_read_ptr) { // data wraps, tail of the buffer first;
+		uart_rx_span(&uart_rx_buf[uart_rx_read_ptr], UART_RX_BUF_LEN - uart_rx_read_ptr);
+		uart_rx_read_ptr = 0;
+	}
+	if (write_ptr > uart_rx_read_ptr) {
+		uart_rx_span(&uart_rx_buf[uart_rx_read_ptr], write_ptr - uart_rx_read_ptr);
+		uart_rx_read_ptr = write_ptr;
+	}
+	return uart_rx_read_ptr == uart_rx_write_ptr && !uart_rx_restarted;
+}
@@ -0,0 +1,113 @@
+/*
+ * uart_tx.c
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+#include <string.h>
+#include "uart_tx.h"
+
+/* [tail - dma_len, tail) is on the wire, [tail, head) waits for the DMA */
+static uint8_t uart_tx_buf[UART_TX_BUF_LEN];
+static volatile uint16_t uart_tx_head;
+static volatile uint16_t uart_tx_tail;
+static volatile uint16_t uart_tx_dma_len;
+static volatile uint32_t uart_tx_lost;
+
+static uint16_t uart_tx_used(void) {
+	return (uart_tx_head + UART_TX_BUF_LEN - uart_tx_tail + uart_tx_dma_len) % UART_TX_BUF_LEN;
+}
+
+/* Hands the next contiguous run to the DMA, called with interrupts masked */
+static void uart_tx_kick(void) {
+	uint16_t len;
+
+	if (uart_tx_dma_len || uart_tx_head == uart_tx_tail) return;
+	if (uart_tx_head > uart_tx_tail) {
+		len = uart_tx_head - uart_tx_tail;
+	} else {
+		len = UART_TX_BUF_LEN - uart_tx_tail; // up to the wrap, the rest is chained from the irq;
+	}
+
+	UART_TX_DMA->CCR &= ~DMA_CCR_EN;
+	UART_TX_DMA->CMAR = (uint32_t) &uart_tx_buf[uart_tx_tail];
+	UART_TX_DMA->CNDTR = len;
+	uart_tx_dma_len = len;
+	uart_tx_tail = (uart_tx_tail + len) % UART_TX_BUF_LEN;
+	UART_TX_DMA->CCR |= DMA_CCR_EN;
+}
+
+void uart_tx_init(void) {
+	__HAL_RCC_DMA1_CLK_ENABLE();
+	UART_TX_DMA->CCR = 0;
+	UART_TX_DMA->CPAR = (uint32_t) &UART_TX_USART->TDR;
+	UART_TX_DMA->CCR = DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_TCIE;
+	UART_TX_USART->CR3 |= USART_CR3_DMAT;
+	HAL_NVIC_SetPriority(UART_TX_DMA_IRQn, 0, 0);
+	HAL_NVIC_EnableIRQ(UART_TX_DMA_IRQn);
+}
+
+uint16_t uart_tx_write(const uint8_t *buf, uint16_t n) {
+	uint16_t done = 0;
+
+	while (done < n) {
+		uint32_t primask = __get_PRIMASK();
+		__disable_irq();
+
+		uint16_t room = UART_TX_BUF_LEN - 1 - uart_tx_used();
+		uint16_t len = n - done;
+#if UART_TX_POLICY == UART_TX_OVERWRITE
+		if (len > UART_TX_BUF_LEN - 1 - uart_tx_dma_len) { // only the newest bytes can fit at all;
+			uart_tx_lost += len - (UART_TX_BUF_LEN - 1 - uart_tx_dma_len);
+			done = n - (UART_TX_BUF_LEN - 1 - uart_tx_dma_len);
+			len = n - done;
+		}
+		if (len > room) {
+			uart_tx_tail = (uart_tx_tail + len - room) % UART_TX_BUF_LEN;
+			uart_tx_lost += len - room;
+			room = len;
+		}
+#endif
+		if (len > room) len = room;
+
+		uint16_t first = UART_TX_BUF_LEN - uart_tx_head;
+		if (first > len) first = len;
+		memcpy(&uart_tx_buf[uart_tx_head], &buf[done], first);
+		memcpy(uart_tx_buf, &buf[done + first], len - first);
+		uart_tx_head = (uart_tx_head + len) % UART_TX_BUF_LEN;
+		done += len;
+		uart_tx_kick();
+
+		__set_PRIMASK(primask);
+#if UART_TX_POLICY == UART_TX_DROP
+		if (done < n) {
+			uart_tx_lost += n - done;
+			break;
+		}
+#elif UART_TX_POLICY == UART_TX_BLOCK
+		if (done < n && primask) { // called with interrupts off, nobody would drain the ring;
+			uart_tx_lost += n - done;
+			break;
+		}
+		while (done < n && uart_tx_used() == UART_TX_BUF_LEN - 1); // ring full, wait for the DMA;
+#endif
+	}
+	return done;
+}
+
+void uart_tx_flush(void) {
+	while (uart_tx_dma_len || uart_tx_head != uart_tx_tail);
+	while (!(UART_TX_USART->ISR & USART_ISR_TC)); // last byte left the shift register;
+}
+
+uint32_t uart_tx_dropped(void) {
+	return uart_tx_lost;
+}
+
+void uart_tx_irq(void) {
+	if (!(DMA1->ISR & UART_TX_DMA_TCIF)) return;
+	DMA1->IFCR = UART_TX_DMA_CLEAR;
+	UART_TX_DMA->CCR &= ~DMA_CCR_EN;
+	uart_tx_dma_len = 0;
+	uart_tx_kick();
+}
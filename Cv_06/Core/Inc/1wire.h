@@ -10,10 +10,27 @@
 
 #include "main.h"
 
+/* Pin access and _delay_us() come from OW_PORT when it names a header,
+ * the host tests put their bus simulator there */
+#ifdef OW_PORT
+#include OW_PORT
+#else
 #define OWInitHw()          { }
 #define OWSetLink(x)        { if (x) DQ_GPIO_Port->BSRR = DQ_Pin; else DQ_GPIO_Port->BRR = DQ_Pin; }
 #define OWGetLink()         ( (DQ_GPIO_Port->IDR & DQ_Pin) ? 1 : 0 )
+#endif
+
+/* Dallas CRC8: 0 bit loop, 1 two 16 byte nibble tables, 2 one 256 byte table */
+#ifndef OW_CRC_TABLE
+#define OW_CRC_TABLE 1
+#endif
+
+/* 1 MHz one-pulse timer pacing the asynchronous engine */
+#define OW_TIM              TIM17
+#define OW_TIM_IRQn         TIM17_IRQn
+#define OW_TIM_CLK_ENABLE() __HAL_RCC_TIM17_CLK_ENABLE()
 
+#ifndef OW_PORT
 /* Dumb delay for F030. Tuned for default clock configuration, i.e. 48MHz with 1 wait state. */
 __attribute__((always_inline))
 inline static void _delay_us(volatile uint32_t micros)
@@ -21,6 +38,7 @@ inline static void _delay_us(volatile uint32_t micros)
     micros = (micros * 19) / 4; /* Go to clock cycles */
     while (micros--); /* Wait till done */
 }
+#endif
 
 /* LOW LEVEL */
 extern void OWInit(void);
@@ -31,11 +49,28 @@ extern void OWWriteByte(uint8_t data);
 extern uint8_t OWReadByte(void);
 extern void OWSendCmd(uint8_t *ROM, uint8_t cmd);
 extern void OWCRC(uint8_t x, uint8_t *crc);
+extern uint8_t OWCRCBuffer(const uint8_t *buf, uint8_t len);
 
 /* HIGH LEVEL */
 extern uint8_t OWReadRom(uint8_t *ROM);
 extern void OWConvertAll(void);
 extern uint8_t OWReadTemperature(int16_t *temperature);
+extern uint8_t OWReadTemperatureRom(uint8_t *ROM, int16_t *temperature);
+
+/* ROM search, OWFirst()/OWNext() return OW_FOUND and fill ROM until the
+ * bus is exhausted. OWSearchAll() collects up to max DS18B20 ROMs. */
+extern int8_t OWFirst(uint8_t *ROM);
+extern int8_t OWNext(uint8_t *ROM);
+extern uint8_t OWSearchAll(uint8_t ROMs[][8], uint8_t max);
+
+/* ASYNC, driven by OWTimerIRQ() with interrupts enabled. Start functions
+ * return 0 while a transaction is running, done(ok) is called from the
+ * timer interrupt. Do not mix with the blocking calls above while busy. */
+typedef void (*OWCallback)(uint8_t ok);
+extern uint8_t OWBusy(void);
+extern uint8_t OWConvertAllStart(OWCallback done);
+extern uint8_t OWReadTemperatureStart(const uint8_t *ROM, volatile int16_t *temperature, OWCallback done);
+extern void OWTimerIRQ(void);
 
 /* INTERNAL CONSTANTS everything below this line */
 
@@ -63,15 +98,25 @@ extern uint8_t OWReadTemperature(int16_t *temperature);
 #define DS18B20_SIG         0x28
 
 /* 1-wire delays */
-#define DELAY_A _delay_us(4)
-#define DELAY_B _delay_us(66)
-#define DELAY_C _delay_us(65)
-#define DELAY_D _delay_us(5)
-#define DELAY_E _delay_us(9)
-#define DELAY_F _delay_us(55)
+#define OW_T_A 4
+#define OW_T_B 66
+#define OW_T_C 65
+#define OW_T_D 5
+#define OW_T_E 9
+#define OW_T_F 55
+#define OW_T_H 510
+#define OW_T_I 70
+#define OW_T_J 410
+
+#define DELAY_A _delay_us(OW_T_A)
+#define DELAY_B _delay_us(OW_T_B)
+#define DELAY_C _delay_us(OW_T_C)
+#define DELAY_D _delay_us(OW_T_D)
+#define DELAY_E _delay_us(OW_T_E)
+#define DELAY_F _delay_us(OW_T_F)
 #define DELAY_G
-#define DELAY_H _delay_us(510)
-#define DELAY_I _delay_us(70)
+#define DELAY_H _delay_us(OW_T_H)
+#define DELAY_I _delay_us(OW_T_I)
 #define DELAY_J _delay_us(3340)
 
 /* Other */
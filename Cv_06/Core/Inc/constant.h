@@ -1,87 +1,22 @@
 /*
  * constant.h
  *
- *  Created on: 2. 11. 2022
- *      Author: xalech00
+ *  Generated by Matlab/ntc_pwl.m from Matlab/ntc.csv, do not edit.
  */
 
 #ifndef INC_CONSTANT_H_
 #define INC_CONSTANT_H_
 
-static const int16_t ntc_lookup_temp[] = { 1689, 1669, 1649, 1630, 1611, 1593, 1575,
-		1558, 1540, 1524, 1507, 1491, 1475, 1460, 1445, 1430, 1415, 1401, 1387,
-		1373, 1360, 1347, 1334, 1322, 1309, 1297, 1285, 1274, 1263, 1251, 1241,
-		1230, 1220, 1209, 1199, 1190, 1180, 1171, 1161, 1152, 1144, 1135, 1126,
-		1118, 1110, 1102, 1094, 1086, 1079, 1071, 1064, 1057, 1050, 1043, 1036,
-		1030, 1023, 1017, 1011, 1005, 999, 993, 987, 981, 976, 970, 965, 960,
-		954, 949, 944, 939, 934, 930, 925, 920, 916, 911, 907, 902, 898, 894,
-		890, 886, 882, 878, 874, 870, 866, 862, 859, 855, 851, 848, 844, 841,
-		837, 834, 831, 827, 824, 821, 818, 814, 811, 808, 805, 802, 799, 796,
-		793, 790, 788, 785, 782, 779, 776, 774, 771, 768, 766, 763, 760, 758,
-		755, 753, 750, 748, 745, 743, 740, 738, 735, 733, 731, 728, 726, 723,
-		721, 719, 717, 714, 712, 710, 707, 705, 703, 701, 699, 696, 694, 692,
-		690, 688, 686, 684, 682, 679, 677, 675, 673, 671, 669, 667, 665, 663,
-		661, 659, 657, 655, 653, 651, 649, 647, 645, 643, 641, 640, 638, 636,
-		634, 632, 630, 628, 626, 625, 623, 621, 619, 617, 615, 614, 612, 610,
-		608, 607, 605, 603, 601, 599, 598, 596, 594, 593, 591, 589, 587, 586,
-		584, 582, 581, 579, 577, 576, 574, 573, 571, 569, 568, 566, 565, 563,
-		561, 560, 558, 557, 555, 554, 552, 550, 549, 547, 546, 544, 543, 541,
-		540, 538, 537, 536, 534, 533, 531, 530, 528, 527, 525, 524, 523, 521,
-		520, 518, 517, 516, 514, 513, 511, 510, 509, 507, 506, 505, 503, 502,
-		501, 499, 498, 497, 496, 494, 493, 492, 490, 489, 488, 487, 485, 484,
-		483, 482, 480, 479, 478, 477, 475, 474, 473, 472, 471, 469, 468, 467,
-		466, 465, 464, 462, 461, 460, 459, 458, 457, 455, 454, 453, 452, 451,
-		450, 449, 448, 446, 445, 444, 443, 442, 441, 440, 439, 438, 437, 435,
-		434, 433, 432, 431, 430, 429, 428, 427, 426, 425, 424, 423, 422, 421,
-		419, 418, 417, 416, 415, 414, 413, 412, 411, 410, 409, 408, 407, 406,
-		405, 404, 403, 402, 401, 400, 399, 398, 397, 396, 395, 394, 393, 392,
-		391, 390, 389, 388, 387, 386, 385, 384, 383, 382, 381, 380, 379, 378,
-		377, 376, 375, 374, 373, 372, 371, 370, 369, 368, 367, 366, 365, 364,
-		363, 362, 361, 360, 359, 358, 358, 357, 356, 355, 354, 353, 352, 351,
-		350, 349, 348, 347, 346, 345, 344, 343, 342, 341, 340, 339, 338, 337,
-		336, 335, 334, 333, 332, 331, 330, 330, 329, 328, 327, 326, 325, 324,
-		323, 322, 321, 320, 319, 318, 317, 316, 315, 314, 313, 312, 311, 310,
-		309, 309, 308, 307, 306, 305, 304, 303, 302, 301, 300, 299, 298, 297,
-		296, 295, 294, 293, 293, 292, 291, 290, 289, 288, 287, 286, 285, 284,
-		283, 282, 281, 280, 279, 279, 278, 277, 276, 275, 274, 273, 272, 271,
-		270, 269, 268, 268, 267, 266, 265, 264, 263, 262, 261, 260, 259, 258,
-		258, 257, 256, 255, 254, 253, 252, 251, 250, 250, 249, 248, 247, 246,
-		245, 244, 243, 242, 242, 241, 240, 239, 238, 237, 236, 235, 235, 234,
-		233, 232, 231, 230, 229, 228, 228, 227, 226, 225, 224, 223, 222, 222,
-		221, 220, 219, 218, 217, 217, 216, 215, 214, 213, 212, 211, 211, 210,
-		209, 208, 207, 206, 206, 205, 204, 203, 202, 201, 201, 200, 199, 198,
-		197, 196, 196, 195, 194, 193, 192, 192, 191, 190, 189, 188, 187, 187,
-		186, 185, 184, 183, 182, 182, 181, 180, 179, 178, 178, 177, 176, 175,
-		174, 173, 173, 172, 171, 170, 169, 169, 168, 167, 166, 165, 164, 164,
-		163, 162, 161, 160, 160, 159, 158, 157, 156, 155, 155, 154, 153, 152,
-		151, 151, 150, 149, 148, 147, 146, 146, 145, 144, 143, 142, 141, 141,
-		140, 139, 138, 137, 136, 135, 135, 134, 133, 132, 131, 130, 130, 129,
-		128, 127, 126, 125, 124, 124, 123, 122, 121, 120, 119, 118, 117, 117,
-		116, 115, 114, 113, 112, 111, 110, 110, 109, 108, 107, 106, 105, 104,
-		103, 102, 102, 101, 100, 99, 98, 97, 96, 95, 94, 93, 92, 92, 91, 90, 89,
-		88, 87, 86, 85, 84, 83, 82, 81, 80, 79, 78, 78, 77, 76, 75, 74, 73, 72,
-		71, 70, 69, 68, 67, 66, 65, 64, 63, 62, 61, 60, 59, 58, 57, 56, 55, 54,
-		53, 52, 51, 50, 49, 48, 47, 46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36,
-		35, 34, 33, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18,
-		17, 16, 15, 14, 13, 12, 11, 10, 9, 7, 6, 5, 4, 3, 2, 1, 0, -1, -2, -3,
-		-4, -5, -6, -7, -8, -9, -11, -12, -13, -14, -15, -16, -17, -18, -19,
-		-20, -21, -22, -24, -25, -26, -27, -28, -29, -30, -31, -32, -33, -35,
-		-36, -37, -38, -39, -40, -41, -42, -44, -45, -46, -47, -48, -49, -50,
-		-52, -53, -54, -55, -56, -57, -59, -60, -61, -62, -63, -64, -66, -67,
-		-68, -69, -71, -72, -73, -74, -75, -77, -78, -79, -80, -82, -83, -84,
-		-86, -87, -88, -89, -91, -92, -93, -95, -96, -97, -99, -100, -101, -103,
-		-104, -106, -107, -108, -110, -111, -113, -114, -116, -117, -119, -120,
-		-122, -123, -125, -126, -128, -129, -131, -132, -134, -136, -137, -139,
-		-140, -142, -144, -145, -147, -149, -150, -152, -154, -156, -157, -159,
-		-161, -163, -165, -166, -168, -170, -172, -174, -176, -178, -180, -182,
-		-184, -186, -188, -190, -192, -194, -196, -198, -200, -202, -204, -207,
-		-209, -211, -213, -215, -218, -220, -222, -224, -227, -229, -231, -234,
-		-236, -239, -241, -243, -246, -248, -251, -253, -256, -258, -261, -264,
-		-266, -269, -271, -274, -277, -279, -282, -285, -287, -290, -293, -295,
-		-298, -301, -304, -307, -309, -312, -315, -318, -321, -324, -326, -329,
-		-332, -335, -338, -341, -344, -347, -349, -352, -355, -358, -361, -364,
-		-367, -370, -372, -375, -378, -381, -384, -387, -389, -392, -395, -398,
-		-401, -403, -406, -409, -411, -414, -416, -419, -422, -424, -427, -429,
-		-431, -434 };
+#define NTC_ADC_BITS 10
+#define NTC_PWL_SHIFT 4
+
+/* NTC temperature in 0.1 C at every 2^NTC_PWL_SHIFT-th ADC code */
+static const int16_t ntc_pwl_temp[] = {
+		1250, 1250, 1223, 1076, 976, 901, 840, 789, 745, 706, 671, 639, 
+		611, 584, 559, 535, 513, 492, 472, 453, 435, 417, 400, 384, 
+		368, 352, 337, 322, 307, 292, 278, 264, 250, 236, 222, 209, 
+		195, 181, 168, 154, 140, 126, 112, 98, 84, 69, 54, 39, 
+		23, 7, -10, -28, -46, -66, -86, -108, -132, -158, -188, -221, 
+		-260, -300, -300, -300, -300, };
 
 #endif /* INC_CONSTANT_H_ */
@@ -0,0 +1,17 @@
+/*
+ * ntc.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+
+#ifndef INC_NTC_H_
+#define INC_NTC_H_
+
+#include <stdint.h>
+
+/* ADC code -> NTC temperature in 0.1 C, piecewise linear between the
+ * breakpoints generated into constant.h by Matlab/ntc_pwl.m */
+int16_t ntc_temp(uint16_t adc);
+
+#endif /* INC_NTC_H_ */
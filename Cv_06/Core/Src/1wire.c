@@ -19,6 +19,14 @@ void OWInit(void)
     OWSetLink(1);
     OWInitHw();
 
+    OW_TIM_CLK_ENABLE();
+    OW_TIM->PSC = 47; /* 1 us tick at 48 MHz */
+    OW_TIM->CR1 = TIM_CR1_OPM | TIM_CR1_URS;
+    OW_TIM->EGR = TIM_EGR_UG; /* load PSC now, URS keeps UIF clear */
+    OW_TIM->DIER = TIM_DIER_UIE;
+    HAL_NVIC_SetPriority(OW_TIM_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(OW_TIM_IRQn);
+
     OWReset();
 }
 
@@ -107,8 +115,44 @@ void OWSendCmd(uint8_t *ROM, uint8_t cmd)
     OWWriteByte(cmd);
 }
 
+#if OW_CRC_TABLE == 2
+static const uint8_t ow_crc_table[256] = {
+    0x00, 0x5E, 0xBC, 0xE2, 0x61, 0x3F, 0xDD, 0x83, 0xC2, 0x9C, 0x7E, 0x20, 0xA3, 0xFD, 0x1F, 0x41,
+    0x9D, 0xC3, 0x21, 0x7F, 0xFC, 0xA2, 0x40, 0x1E, 0x5F, 0x01, 0xE3, 0xBD, 0x3E, 0x60, 0x82, 0xDC,
+    0x23, 0x7D, 0x9F, 0xC1, 0x42, 0x1C, 0xFE, 0xA0, 0xE1, 0xBF, 0x5D, 0x03, 0x80, 0xDE, 0x3C, 0x62,
+    0xBE, 0xE0, 0x02, 0x5C, 0xDF, 0x81, 0x63, 0x3D, 0x7C, 0x22, 0xC0, 0x9E, 0x1D, 0x43, 0xA1, 0xFF,
+    0x46, 0x18, 0xFA, 0xA4, 0x27, 0x79, 0x9B, 0xC5, 0x84, 0xDA, 0x38, 0x66, 0xE5, 0xBB, 0x59, 0x07,
+    0xDB, 0x85, 0x67, 0x39, 0xBA, 0xE4, 0x06, 0x58, 0x19, 0x47, 0xA5, 0xFB, 0x78, 0x26, 0xC4, 0x9A,
+    0x65, 0x3B, 0xD9, 0x87, 0x04, 0x5A, 0xB8, 0xE6, 0xA7, 0xF9, 0x1B, 0x45, 0xC6, 0x98, 0x7A, 0x24,
+    0xF8, 0xA6, 0x44, 0x1A, 0x99, 0xC7, 0x25, 0x7B, 0x3A, 0x64, 0x86, 0xD8, 0x5B, 0x05, 0xE7, 0xB9,
+    0x8C, 0xD2, 0x30, 0x6E, 0xED, 0xB3, 0x51, 0x0F, 0x4E, 0x10, 0xF2, 0xAC, 0x2F, 0x71, 0x93, 0xCD,
+    0x11, 0x4F, 0xAD, 0xF3, 0x70, 0x2E, 0xCC, 0x92, 0xD3, 0x8D, 0x6F, 0x31, 0xB2, 0xEC, 0x0E, 0x50,
+    0xAF, 0xF1, 0x13, 0x4D, 0xCE, 0x90, 0x72, 0x2C, 0x6D, 0x33, 0xD1, 0x8F, 0x0C, 0x52, 0xB0, 0xEE,
+    0x32, 0x6C, 0x8E, 0xD0, 0x53, 0x0D, 0xEF, 0xB1, 0xF0, 0xAE, 0x4C, 0x12, 0x91, 0xCF, 0x2D, 0x73,
+    0xCA, 0x94, 0x76, 0x28, 0xAB, 0xF5, 0x17, 0x49, 0x08, 0x56, 0xB4, 0xEA, 0x69, 0x37, 0xD5, 0x8B,
+    0x57, 0x09, 0xEB, 0xB5, 0x36, 0x68, 0x8A, 0xD4, 0x95, 0xCB, 0x29, 0x77, 0xF4, 0xAA, 0x48, 0x16,
+    0xE9, 0xB7, 0x55, 0x0B, 0x88, 0xD6, 0x34, 0x6A, 0x2B, 0x75, 0x97, 0xC9, 0x4A, 0x14, 0xF6, 0xA8,
+    0x74, 0x2A, 0xC8, 0x96, 0x15, 0x4B, 0xA9, 0xF7, 0xB6, 0xE8, 0x0A, 0x54, 0xD7, 0x89, 0x6B, 0x35,
+};
+
+#define OW_CRC_STEP(crc, x) (ow_crc_table[(crc) ^ (x)])
+#elif OW_CRC_TABLE == 1
+/* crc(a ^ b) = crc(a) ^ crc(b), so low and high nibble are looked up apart */
+static const uint8_t ow_crc_lo[16] = {
+    0x00, 0x5E, 0xBC, 0xE2, 0x61, 0x3F, 0xDD, 0x83, 0xC2, 0x9C, 0x7E, 0x20, 0xA3, 0xFD, 0x1F, 0x41,
+};
+static const uint8_t ow_crc_hi[16] = {
+    0x00, 0x9D, 0x23, 0xBE, 0x46, 0xDB, 0x65, 0xF8, 0x8C, 0x11, 0xAF, 0x32, 0xCA, 0x57, 0xE9, 0x74,
+};
+
+#define OW_CRC_STEP(crc, x) (ow_crc_lo[((crc) ^ (x)) & 0x0F] ^ ow_crc_hi[((crc) ^ (x)) >> 4])
+#endif
+
 void OWCRC(uint8_t x, uint8_t *crc)
 {
+#ifdef OW_CRC_STEP
+    *crc = OW_CRC_STEP(*crc, x);
+#else
     for (uint8_t i = 8; i; i--) {
         uint8_t mix = (*crc ^ x) & 0x01;
         *crc >>= 1;
@@ -117,6 +161,21 @@ void OWCRC(uint8_t x, uint8_t *crc)
         }
         x >>= 1;
     }
+#endif
+}
+
+uint8_t OWCRCBuffer(const uint8_t *buf, uint8_t len)
+{
+    uint8_t i, crc = 0;
+
+    for (i = 0; i < len; i++) {
+#ifdef OW_CRC_STEP
+        crc = OW_CRC_STEP(crc, buf[i]);
+#else
+        OWCRC(buf[i], &crc);
+#endif
+    }
+    return crc;
 }
 
 /******************************************************************
@@ -125,18 +184,15 @@ void OWCRC(uint8_t x, uint8_t *crc)
 
 uint8_t OWReadRom(uint8_t *ROM)
 {
-    uint8_t i, crc = 0;
+    uint8_t i;
 
     OWReset();
     OWWriteByte(OW_READ_ROM_CMD);
 
-    for (i = 0; i < 7; i++) {
+    for (i = 0; i < 8; i++)
         ROM[i] = OWReadByte();
-        OWCRC(ROM[i], &crc);
-    }
-    ROM[7] = OWReadByte();
 
-    if (crc != ROM[7]) return 0;
+    if (OWCRCBuffer(ROM, 7) != ROM[7]) return 0;
     if (ROM[0] != DS18B20_SIG) return 0;
 
     return 1;
@@ -147,21 +203,279 @@ void OWConvertAll(void)
     OWSendCmd(NULL, OW_CONVERT_T_CMD);
 }
 
+static int16_t OWScratchpadTemp(const uint8_t *buf)
+{
+    return (int8_t)((buf[1] << 4) | (buf[0] >> 4)) * 100 + (buf[0] & 0x0F) * 100 / 16;
+}
+
 uint8_t OWReadTemperature(int16_t *result)
 {
-    uint8_t i, crc = 0, buf[8];
+    return OWReadTemperatureRom(NULL, result);
+}
 
-    OWSendCmd(NULL, OW_RD_SCR_CMD);
-    for (i = 0; i < 8; i++) {
+uint8_t OWReadTemperatureRom(uint8_t *ROM, int16_t *result)
+{
+    uint8_t i, buf[9];
+
+    OWSendCmd(ROM, OW_RD_SCR_CMD);
+    for (i = 0; i < 9; i++)
         buf[i] = OWReadByte();
-        OWCRC(buf[i], &crc);
-    }
-    if (crc != OWReadByte()) {
+    if (OWCRCBuffer(buf, 8) != buf[8]) {
         *result = OW_ERR_BADCRC;
         return 0;
     }
 
-    *result = (int8_t)((buf[1] << 4) | (buf[0] >> 4)) * 100 + (buf[0] & 0x0F) * 100 / 16;
+    *result = OWScratchpadTemp(buf);
 
     return 1;
 }
+
+/******************************************************************
+ * ROM search, see Maxim application note 187
+ ******************************************************************/
+
+static uint8_t ow_last_discrepancy;
+static uint8_t ow_last_device;
+static uint8_t ow_rom[8];
+
+int8_t OWFirst(uint8_t *ROM)
+{
+    ow_last_discrepancy = 0;
+    ow_last_device = 0;
+    return OWNext(ROM);
+}
+
+int8_t OWNext(uint8_t *ROM)
+{
+    uint8_t i, bit, cmp, dir;
+    uint8_t last_zero = 0;
+
+    if (ow_last_device) return OW_NOMODULES;
+    if (OWReset()) return OW_NOPRESENCE;
+    OWWriteByte(OW_SEARCH_ROM_CMD);
+
+    for (i = 1; i <= 64; i++) {
+        uint8_t byte = (i - 1) >> 3;
+        uint8_t mask = 1 << ((i - 1) & 7);
+
+        bit = OWReadBit();
+        cmp = OWReadBit();
+        if (bit && cmp) /* nobody left on the bus */
+            return (i == 1) ? OW_NOMODULES : OW_BADWIRE;
+
+        if (bit != cmp) {
+            dir = bit;
+        } else {
+            /* both 0: devices differ here, pick the branch */
+            if (i < ow_last_discrepancy)
+                dir = (ow_rom[byte] & mask) ? 1 : 0;
+            else
+                dir = (i == ow_last_discrepancy);
+            if (!dir)
+                last_zero = i;
+        }
+
+        if (dir)
+            ow_rom[byte] |= mask;
+        else
+            ow_rom[byte] &= ~mask;
+        OWWriteBit(dir);
+    }
+
+    ow_last_discrepancy = last_zero;
+    if (last_zero == 0)
+        ow_last_device = 1;
+
+    if (OWCRCBuffer(ow_rom, 7) != ow_rom[7]) {
+        ow_last_device = 1;
+        return OW_BADCRC;
+    }
+
+    for (i = 0; i < 8; i++)
+        ROM[i] = ow_rom[i];
+    return OW_FOUND;
+}
+
+uint8_t OWSearchAll(uint8_t ROMs[][8], uint8_t max)
+{
+    uint8_t rom[8];
+    uint8_t count = 0;
+    uint8_t i;
+    int8_t res;
+
+    /* search into rom[], ROMs[] only takes what fits */
+    for (res = OWFirst(rom); res == OW_FOUND && count < max; res = OWNext(rom)) {
+        if (rom[0] != DS18B20_SIG)
+            continue;
+        for (i = 0; i < 8; i++)
+            ROMs[count][i] = rom[i];
+        count++;
+    }
+    return count;
+}
+
+/******************************************************************
+ * ASYNC functions for 1-wire bus
+ *
+ * Reset pulses, write-0 slots and slot recovery are timed by OW_TIM.
+ * Only the short parts of a slot (A, A+E) are busy-waited inside the
+ * interrupt, the same way the blocking functions do them.
+ ******************************************************************/
+
+#define OW_ASYNC_BUF 19 /* match ROM + ROM + command + scratchpad */
+
+enum {
+    OW_STEP_RESET_RELEASE,
+    OW_STEP_RESET_SAMPLE,
+    OW_STEP_SLOT,
+    OW_STEP_WRITE0_RELEASE,
+};
+
+static struct {
+    uint8_t buf[OW_ASYNC_BUF]; /* bytes to send followed by bytes to read */
+    uint8_t tx_len;
+    uint8_t len;
+    uint8_t pos;
+    uint8_t bit;
+    uint8_t step;
+    volatile uint8_t busy;
+    volatile int16_t *result;
+    OWCallback done;
+} ow;
+
+static void OWSchedule(uint16_t micros)
+{
+    OW_TIM->ARR = micros;
+    OW_TIM->CNT = 0;
+    OW_TIM->CR1 |= TIM_CR1_CEN;
+}
+
+static void OWFinish(uint8_t ok)
+{
+    if (ok && ow.result != NULL) {
+        uint8_t *scr = &ow.buf[ow.tx_len];
+
+        if (OWCRCBuffer(scr, 8) == scr[8]) {
+            *ow.result = OWScratchpadTemp(scr);
+        } else {
+            *ow.result = OW_ERR_BADCRC;
+            ok = 0;
+        }
+    }
+    ow.busy = 0;
+    if (ow.done != NULL)
+        ow.done(ok);
+}
+
+static void OWNextBit(void)
+{
+    if (++ow.bit == 8) {
+        ow.bit = 0;
+        ow.pos++;
+    }
+}
+
+static uint8_t OWStart(uint8_t tx_len, uint8_t rx_len, volatile int16_t *result, OWCallback done)
+{
+    uint8_t i;
+
+    for (i = tx_len; i < tx_len + rx_len; i++)
+        ow.buf[i] = 0;
+    ow.tx_len = tx_len;
+    ow.len = tx_len + rx_len;
+    ow.pos = 0;
+    ow.bit = 0;
+    ow.result = result;
+    ow.done = done;
+
+    OWSetLink(0);
+    ow.step = OW_STEP_RESET_RELEASE;
+    OWSchedule(OW_T_H);
+    return 1;
+}
+
+uint8_t OWBusy(void)
+{
+    return ow.busy;
+}
+
+uint8_t OWConvertAllStart(OWCallback done)
+{
+    if (ow.busy) return 0;
+    ow.busy = 1;
+    ow.buf[0] = OW_SKIP_ROM_CMD;
+    ow.buf[1] = OW_CONVERT_T_CMD;
+    return OWStart(2, 0, NULL, done);
+}
+
+uint8_t OWReadTemperatureStart(const uint8_t *ROM, volatile int16_t *result, OWCallback done)
+{
+    uint8_t i, len = 0;
+
+    if (ow.busy) return 0;
+    ow.busy = 1;
+    if (ROM == NULL) {
+        ow.buf[len++] = OW_SKIP_ROM_CMD;
+    } else {
+        ow.buf[len++] = OW_MATCH_ROM_CMD;
+        for (i = 0; i < 8; i++)
+            ow.buf[len++] = ROM[i];
+    }
+    ow.buf[len++] = OW_RD_SCR_CMD;
+    return OWStart(len, 9, result, done);
+}
+
+void OWTimerIRQ(void)
+{
+    if (!(OW_TIM->SR & TIM_SR_UIF)) return;
+    OW_TIM->SR = ~TIM_SR_UIF;
+
+    switch (ow.step) {
+    case OW_STEP_RESET_RELEASE:
+        OWSetLink(1);
+        ow.step = OW_STEP_RESET_SAMPLE;
+        OWSchedule(OW_T_I);
+        break;
+
+    case OW_STEP_RESET_SAMPLE:
+        if (OWGetLink()) { /* nobody answered */
+            OWFinish(0);
+            break;
+        }
+        ow.step = OW_STEP_SLOT;
+        OWSchedule(OW_T_J);
+        break;
+
+    case OW_STEP_SLOT:
+        if (ow.pos >= ow.len) {
+            OWFinish(1);
+        } else if (ow.pos >= ow.tx_len) {
+            OWSetLink(0);
+            DELAY_A;
+            OWSetLink(1);
+            DELAY_E;
+            if (OWGetLink())
+                ow.buf[ow.pos] |= 1 << ow.bit;
+            OWNextBit();
+            OWSchedule(OW_T_F);
+        } else if (ow.buf[ow.pos] & (1 << ow.bit)) {
+            OWSetLink(0);
+            DELAY_A;
+            OWSetLink(1);
+            OWNextBit();
+            OWSchedule(OW_T_B);
+        } else {
+            OWSetLink(0);
+            ow.step = OW_STEP_WRITE0_RELEASE;
+            OWSchedule(OW_T_C);
+        }
+        break;
+
+    case OW_STEP_WRITE0_RELEASE:
+        OWSetLink(1);
+        OWNextBit();
+        ow.step = OW_STEP_SLOT;
+        OWSchedule(OW_T_D);
+        break;
+    }
+}
@@ -23,7 +23,9 @@
 /* USER CODE BEGIN Includes */
 #include "1wire.h"
 #include "sct.h"
-#include "constant.h"
+#include "ntc.h"
+#include "filter.h"
+#include "sched.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -33,11 +35,12 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-#define CONVERT_T_DELAY 750
+
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
 /* USER CODE BEGIN PM */
+#define OW_MAX_DEVICES 4
 
 /* USER CODE END PM */
 
@@ -47,6 +50,13 @@ ADC_HandleTypeDef hadc;
 UART_HandleTypeDef huart2;
 
 /* USER CODE BEGIN PV */
+static filter_ema_t ntc_filter;
+static uint8_t ow_rom[OW_MAX_DEVICES][8];
+static uint8_t ow_count;
+static uint8_t ow_next;
+static volatile int16_t ow_temp[OW_MAX_DEVICES];
+static uint8_t temp_switch = 0;
+static volatile uint32_t ow_conv_tick;
 
 /* USER CODE END PV */
 
@@ -61,6 +71,64 @@ static void MX_ADC_Init(void);
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
+static void ow_conv_done(uint8_t ok) {
+	ow_conv_tick = HAL_GetTick(); // the 750 ms run from the end of the command;
+}
+
+static void ow_read_done(uint8_t ok) {
+	if (++ow_next < ow_count) { // read the scratchpads one after another;
+		OWReadTemperatureStart(ow_rom[ow_next], &ow_temp[ow_next], ow_read_done);
+	} else {
+		OWConvertAllStart(ow_conv_done); // one conversion for all sensors while we wait 750 ms;
+	}
+}
+
+static void ow_poll_start(void) {
+	ow_next = 0;
+	if (ow_count == 0) { // search failed, try a single sensor with skip rom;
+		OWReadTemperatureStart(NULL, &ow_temp[0], ow_read_done);
+	} else {
+		OWReadTemperatureStart(ow_rom[0], &ow_temp[0], ow_read_done);
+	}
+}
+
+static void measure_task(void) {
+	uint32_t elapsed = HAL_GetTick() - ow_conv_tick;
+
+	if (OWBusy() || elapsed < CONVERT_T_DELAY) { // conversion not finished yet;
+		sched_after(OWBusy() ? 1 : CONVERT_T_DELAY - elapsed, measure_task);
+		return;
+	}
+	ow_poll_start();
+	sched_after(CONVERT_T_DELAY, measure_task);
+}
+
+static void display_task(void) {
+	uint16_t ntc_raw = HAL_ADC_GetValue(&hadc);
+	int16_t NTC_temp = ntc_temp(filter_ema_block(&ntc_filter, &ntc_raw, 1, 1));
+	if (temp_switch == 0) {
+		sct_value(NTC_temp, 8);
+	} else if (temp_switch == 1) {
+		int16_t ow = ow_temp[0];
+		if (ow == (int16_t) OW_ERR_BADCRC || ow == (int16_t) OW_ERR_BADFAMILY) {
+			sct_show(sct_format_dec(-1000, 0), 1); // out of range, shows "---";
+		} else {
+			sct_show(sct_format_dec(ow / 10, 1), 1);
+		}
+	}
+}
+
+static void button_task(void) {
+	if (HAL_GPIO_ReadPin(S1_GPIO_Port, S1_Pin) == 0) {
+		temp_switch = 1; //store state if switch S1 is on
+		HAL_GPIO_WritePin(LED1_GPIO_Port, LED1_Pin, 0); //light up  LED1
+		HAL_GPIO_WritePin(LED2_GPIO_Port, LED2_Pin, 1);
+	} else if (HAL_GPIO_ReadPin(S2_GPIO_Port, S2_Pin) == 0) {
+		temp_switch = 0; //store state if switch S2 is on
+		HAL_GPIO_WritePin(LED1_GPIO_Port, LED1_Pin, 1);
+		HAL_GPIO_WritePin(LED2_GPIO_Port, LED2_Pin, 0);
+	}
+}
 
 /* USER CODE END 0 */
 
@@ -96,18 +164,18 @@ int main(void)
   MX_ADC_Init();
   /* USER CODE BEGIN 2 */
   OWInit();
+  ow_count = OWSearchAll(ow_rom, OW_MAX_DEVICES);
+  ow_conv_tick = HAL_GetTick();
+  OWConvertAllStart(ow_conv_done);
   sct_init();
   HAL_ADCEx_Calibration_Start(&hadc);
   HAL_ADC_Start(&hadc);
+  HAL_ADC_PollForConversion(&hadc, 10); // seed the filter with a real sample;
+  filter_ema_init(&ntc_filter, 2, HAL_ADC_GetValue(&hadc));
 
-  static enum {CONVERT, BTN_CHECK, VALUE_GET, VALUE_DISPLAY, STATE_SW } state = STATE_SW;
-
-  static uint8_t temp_switch = 0;
-  static int16_t NTC_temp;
-//  static int16_t convert_delay;
-//  static int16_t btn_delay;
-//  static int16_t display_delay;
-  static int16_t temp_18b20;
+  sched_after(CONVERT_T_DELAY, measure_task);
+  sched_every(100, display_task);
+  sched_every(40, button_task);
 
   /* USER CODE END 2 */
 
@@ -115,106 +183,7 @@ int main(void)
   /* USER CODE BEGIN WHILE */
   while (1)
   {
-
-static uint32_t last_measure = 0;
-static uint32_t last_display = 0;
-static uint32_t last_btn = 0;
-
-		if (HAL_GetTick() >= last_measure + 750) {
-			last_measure = HAL_GetTick();
-			OWConvertAll();
-			OWReadTemperature(&temp_18b20);
-		}
-		if (HAL_GetTick() >= last_display + 100) {
-			last_display = HAL_GetTick();
-
-			NTC_temp = ntc_lookup_temp[HAL_ADC_GetValue(&hadc)];
-			if (temp_switch == 0){
-			sct_value(NTC_temp, 8);
-			}
-			else if (temp_switch == 1)
-			{
-			sct_value(temp_18b20 / 10, 1);
-			}
-
-		}
-		if (HAL_GetTick() >= last_btn + 40) {
-			last_btn = HAL_GetTick();
-			if (HAL_GPIO_ReadPin(S1_GPIO_Port, S1_Pin) == 0) {
-				temp_switch = 1; //store state if switch S1 is on
-				HAL_GPIO_WritePin(LED1_GPIO_Port, LED1_Pin, 0); //light up  LED1
-				HAL_GPIO_WritePin(LED2_GPIO_Port, LED2_Pin, 1);
-			} else if (HAL_GPIO_ReadPin(S2_GPIO_Port, S2_Pin) == 0) {
-				temp_switch = 0; //store state if switch S2 is on
-				HAL_GPIO_WritePin(LED1_GPIO_Port, LED1_Pin, 1);
-				HAL_GPIO_WritePin(LED2_GPIO_Port, LED2_Pin, 0);
-			}
-		}
-
-
-//	  switch (state)
-//	 		  {
-//	 			case CONVERT: // one wire conversation begin
-//	 				OWConvertAll();
-//	 				convert_delay = HAL_GetTick();
-//	 				state = STATE_SW;
-//	 				break;
-//
-//	 			case BTN_CHECK: //check button state of S1 S2
-//	 				btn_delay = HAL_GetTick();
-//	 				state = STATE_SW;
-//	 				if (HAL_GPIO_ReadPin(S1_GPIO_Port, S1_Pin) == 0)
-//	 				{
-//	 					temp_switch = 1; //store state if switch S1 is on
-//	 					HAL_GPIO_WritePin(LED1_GPIO_Port, LED1_Pin, 0); //light up  LED1
-//	 					HAL_GPIO_WritePin(LED2_GPIO_Port, LED2_Pin, 1);
-//	 					state = VALUE_DISPLAY;
-//	 				}
-//	 				else if (HAL_GPIO_ReadPin(S2_GPIO_Port, S2_Pin) == 0)
-//	 				{
-//	 					temp_switch = 0; //store state if switch S2 is on
-//	 					HAL_GPIO_WritePin(LED1_GPIO_Port, LED1_Pin, 1);
-//	 					HAL_GPIO_WritePin(LED2_GPIO_Port, LED2_Pin, 0);
-//	 					state = VALUE_DISPLAY;
-//	 				}
-//	 				break;
-//
-//	 			case VALUE_GET:
-//	 				OWReadTemperature(&temp_18b20);
-//	 				NTC_temp = ntc_lookup_temp[HAL_ADC_GetValue(&hadc)];
-//	 				state = CONVERT;
-//	 				break;
-//
-//	 			case VALUE_DISPLAY:
-//	 				display_delay = HAL_GetTick();
-//	 				if (temp_switch == 0)
-//	 				{
-//	 					sct_value(NTC_temp, 8);
-//	 				}
-//	 				else if (temp_switch == 1)
-//	 				{
-//	 					sct_value(temp_18b20 / 10, 1);
-//	 				}
-//	 				state = STATE_SW;
-//	 				break;
-//
-//	 			case STATE_SW:
-//	 				if (HAL_GetTick() > convert_delay + 750)
-//	 				{
-//	 					state = VALUE_GET;
-//	 				}
-//	 				else if (HAL_GetTick() > display_delay  + 100)
-//	 				{
-//	 					state = VALUE_DISPLAY;
-//	 				}
-//	 				else if (HAL_GetTick() > btn_delay + 40)
-//	 				{
-//	 					state = BTN_CHECK;
-//	 				}
-//	 				break;
-//
-//	 			default:
-//	 				break;
+		sched_run();
     /* USER CODE END WHILE */
 
 
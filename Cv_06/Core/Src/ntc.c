@@ -0,0 +1,22 @@
+/*
+ * ntc.c
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+#include <stdint.h>
+#include "ntc.h"
+#include "constant.h"
+
+#define NTC_SEG_LEN (1 << NTC_PWL_SHIFT)
+
+int16_t ntc_temp(uint16_t adc) {
+	if (adc >= 1 << NTC_ADC_BITS) adc = (1 << NTC_ADC_BITS) - 1;
+
+	uint16_t i = adc >> NTC_PWL_SHIFT;
+	int32_t t0 = ntc_pwl_temp[i];
+	int32_t dt = ntc_pwl_temp[i + 1] - t0;
+	int32_t frac = adc & (NTC_SEG_LEN - 1);
+
+	return t0 + ((dt * frac + NTC_SEG_LEN / 2) >> NTC_PWL_SHIFT);
+}
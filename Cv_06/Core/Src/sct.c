@@ -9,8 +9,66 @@
 #include "sct.h"
 #include "main.h"
 
+/* Segment bits of a glyph, independent of where the digit sits in the frame */
+#define SEG_A 0x01
+#define SEG_B 0x02
+#define SEG_C 0x04
+#define SEG_D 0x08
+#define SEG_E 0x10
+#define SEG_F 0x20
+#define SEG_G 0x40
+#define SEG_P 0x80
 
+#define SEG_BIT(g, seg, bit) (((g) & (seg)) ? 1UL << (bit) : 0)
+//PCDE--------GFAB @ DIS1, DIS3
+#define SCT_POS13(g) (SEG_BIT(g, SEG_B, 0) | SEG_BIT(g, SEG_A, 1) \
+		| SEG_BIT(g, SEG_F, 2) | SEG_BIT(g, SEG_G, 3) | SEG_BIT(g, SEG_E, 12) \
+		| SEG_BIT(g, SEG_D, 13) | SEG_BIT(g, SEG_C, 14) | SEG_BIT(g, SEG_P, 15))
+//----PCDEGFAB---- @ DIS2
+#define SCT_POS2(g) (SEG_BIT(g, SEG_B, 4) | SEG_BIT(g, SEG_A, 5) \
+		| SEG_BIT(g, SEG_F, 6) | SEG_BIT(g, SEG_G, 7) | SEG_BIT(g, SEG_E, 8) \
+		| SEG_BIT(g, SEG_D, 9) | SEG_BIT(g, SEG_C, 10) | SEG_BIT(g, SEG_P, 11))
 
+#define SCT_DIS1(g) (SCT_POS13(g) << 16),
+#define SCT_DIS2(g) (SCT_POS2(g) << 0),
+#define SCT_DIS3(g) (SCT_POS13(g) << 0),
+
+/* 0-9, A-F, '-', blank */
+#define SCT_GLYPHS(X) \
+	X(0x3F) X(0x06) X(0x5B) X(0x4F) X(0x66) X(0x6D) X(0x7D) X(0x07) \
+	X(0x7F) X(0x6F) X(0x77) X(0x7C) X(0x39) X(0x5E) X(0x79) X(0x71) \
+	X(SEG_G) X(0x00)
+#define SCT_DASH 16
+#define SCT_BLANK 17
+
+static const uint32_t sct_digits[3][18] = {
+	{ SCT_GLYPHS(SCT_DIS1) },
+	{ SCT_GLYPHS(SCT_DIS2) },
+	{ SCT_GLYPHS(SCT_DIS3) },
+};
+static const uint32_t sct_points[3] = {
+	SCT_POS13(SEG_P) << 16, SCT_POS2(SEG_P), SCT_POS13(SEG_P),
+};
+static const uint32_t sct_bar[9] = {
+	//----43215678---- @ LED
+	0b0000000000000000 << 16,
+	0b0000000100000000 << 16,
+	0b0000001100000000 << 16,
+	0b0000011100000000 << 16,
+	0b0000111100000000 << 16,
+	0b0000111110000000 << 16,
+	0b0000111111000000 << 16,
+	0b0000111111100000 << 16,
+	0b0000111111110000 << 16,
+};
+
+/* Last frame actually shifted out and last sct_value() arguments, so repeated
+ * calls with an unchanged value cost a compare instead of a refresh. */
+static uint32_t sct_last_frame;
+static uint16_t sct_last_value;
+static uint16_t sct_last_led;
+static uint8_t sct_frame_valid;
+static uint8_t sct_value_valid;
 
 void sct_init(void) {
 //	RCC->AHBENR |= RCC_AHBENR_GPIOBEN; // enable clock;
@@ -21,6 +79,7 @@ void sct_init(void) {
 	sct_led(0);
 }
 void sct_led(uint32_t value) {
+	sct_frame_valid = sct_value_valid = 0; // raw frame, forget the cache;
 	for (uint32_t i=0; i<32; i++){
 		HAL_GPIO_WritePin(SCT_SDI_GPIO_Port, SCT_SDI_Pin, value & 1);
 		HAL_GPIO_WritePin(SCT_CLK_GPIO_Port, SCT_CLK_Pin, 1); //clock pulse;
@@ -30,71 +89,60 @@ void sct_led(uint32_t value) {
 	HAL_GPIO_WritePin(SCT_NLA_GPIO_Port, SCT_NLA_Pin, 1); //latch bit pulse;
 	HAL_GPIO_WritePin(SCT_NLA_GPIO_Port, SCT_NLA_Pin, 0);
 }
-void sct_value(uint16_t value, uint16_t led) {
-	static const uint32_t reg_values[4][10] = {
-	{
-	//PCDE--------GFAB @ DIS1
-	0b0111000000000111 << 16,
-	0b0100000000000001 << 16,
-	0b0011000000001011 << 16,
-	0b0110000000001011 << 16,
-	0b0100000000001101 << 16,
-	0b0110000000001110 << 16,
-	0b0111000000001110 << 16,
-	0b0100000000000011 << 16,
-	0b0111000000001111 << 16,
-	0b0110000000001111 << 16,
-	},
-	{
-	//----PCDEGFAB---- @ DIS2
-	0b0000011101110000 << 0,
-	0b0000010000010000 << 0,
-	0b0000001110110000 << 0,
-	0b0000011010110000 << 0,
-	0b0000010011010000 << 0,
-	0b0000011011100000 << 0,
-	0b0000011111100000 << 0,
-	0b0000010000110000 << 0,
-	0b0000011111110000 << 0,
-    0b0000011011110000 << 0,
-
+uint32_t sct_format_dec(int16_t value, uint8_t dp) {
+	uint8_t digit[3];
+	uint8_t neg = value < 0;
+	uint16_t mag = neg ? -value : value;
+	uint8_t i;
 
+	if (dp > 2 || mag > (neg ? 99 : 999) || (neg && dp == 2)) {
+		return sct_digits[0][SCT_DASH] | sct_digits[1][SCT_DASH]
+				| sct_digits[2][SCT_DASH];
+	}
+	digit[2] = mag % 10;
+	digit[1] = mag / 10 % 10;
+	digit[0] = mag / 100;
+	for (i = 0; i < 2 - dp && digit[i] == 0; i++) {
+		digit[i] = SCT_BLANK; // leading zeros up to the decimal point;
+	}
+	if (neg) {
+		digit[i - 1] = SCT_DASH;
+	}
 
-	},
-	{
-	//PCDE--------GFAB @ DIS3
-	0b0111000000000111 << 0,
-	0b0100000000000001 << 0,
-	0b0011000000001011 << 0,
-	0b0110000000001011 << 0,
-	0b0100000000001101 << 0,
-	0b0110000000001110 << 0,
-	0b0111000000001110 << 0,
-	0b0100000000000011 << 0,
-	0b0111000000001111 << 0,
-	0b0110000000001111 << 0,
-	},
-	{
-	//----43215678---- @ LED
-	0b0000000000000000 << 16,
-	0b0000000100000000 << 16,
-	0b0000001100000000 << 16,
-	0b0000011100000000 << 16,
-	0b0000111100000000 << 16,
-	0b0000111110000000 << 16,
-	0b0000111111000000 << 16,
-	0b0000111111100000 << 16,
-	0b0000111111110000 << 16,
-	},
-	};
-	uint32_t reg=0;
-	reg |= reg_values[0][value / 100 % 10];
-	reg |= reg_values[1][value / 10 % 10];
-	reg |= reg_values[2][value / 1 % 10];
-	reg |= reg_values[3][led];
-	reg |= 1<<11;
-	sct_led(reg);
+	uint32_t reg = sct_digits[0][digit[0]] | sct_digits[1][digit[1]]
+			| sct_digits[2][digit[2]];
+	if (dp) {
+		reg |= sct_points[2 - dp];
+	}
+	return reg;
+}
 
+uint32_t sct_format_hex(uint16_t value) {
+	return sct_digits[0][value >> 8 & 0xF] | sct_digits[1][value >> 4 & 0xF]
+			| sct_digits[2][value & 0xF];
 }
 
+void sct_show(uint32_t frame, uint16_t led) {
+	frame |= sct_bar[led];
+	if (sct_frame_valid && frame == sct_last_frame) {
+		return;
+	}
+	sct_led(frame);
+	sct_last_frame = frame;
+	sct_frame_valid = 1;
+}
 
+void sct_value(uint16_t value, uint16_t led) {
+	if (sct_value_valid && value == sct_last_value && led == sct_last_led) {
+		return;
+	}
+	uint32_t reg=0;
+	reg |= sct_digits[0][value / 100 % 10];
+	reg |= sct_digits[1][value / 10 % 10];
+	reg |= sct_digits[2][value / 1 % 10];
+	reg |= sct_points[1];
+	sct_show(reg, led);
+	sct_last_value = value;
+	sct_last_led = led;
+	sct_value_valid = 1;
+}
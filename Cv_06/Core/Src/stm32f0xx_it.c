@@ -22,6 +22,7 @@
 #include "stm32f0xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "1wire.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -141,5 +142,12 @@ void SysTick_Handler(void)
 /******************************************************************************/
 
 /* USER CODE BEGIN 1 */
+/**
+  * @brief This function handles TIM17 global interrupt, 1-wire slot timing.
+  */
+void TIM17_IRQHandler(void)
+{
+  OWTimerIRQ();
+}
 
 /* USER CODE END 1 */
@@ -0,0 +1,48 @@
+clear all;
+tab=csvread("ntc.csv");
+temp=tab(:,1);
+R_NTC=tab(:,2);
+
+ADC_bit_word_size=10; % has to match hadc.Init.Resolution
+PWL_shift=4; % 2^PWL_shift ADC codes per linear segment
+ADC_range=2^ADC_bit_word_size;
+seg=2^PWL_shift;
+
+ADC_Val=ADC_range*(R_NTC./(R_NTC+10));
+
+% breakpoints taken from the measured curve, clamped to its ends
+ADC_bp=0:seg:ADC_range;
+ADC_bp_clamped=min(max(ADC_bp, min(ADC_Val)), max(ADC_Val));
+temp_bp=round(10*interp1(ADC_Val, temp, ADC_bp_clamped));
+
+% same integer interpolation as ntc_temp() in Core/Src/ntc.c
+ADC_Val_2=0:ADC_range-1;
+i=floor(ADC_Val_2/seg)+1;
+frac=mod(ADC_Val_2, seg);
+temp_pwl=temp_bp(i)+floor(((temp_bp(i+1)-temp_bp(i)).*frac+seg/2)/seg);
+
+% accuracy against the measured curve and the old polynomial table
+in_range=ADC_Val_2>=ceil(min(ADC_Val)) & ADC_Val_2<=floor(max(ADC_Val));
+temp_ref=10*interp1(ADC_Val, temp, ADC_Val_2(in_range));
+temp_old=csvread("data.dlm");
+fprintf("PWL: %d bytes, max error %.2f C\n", 2*numel(temp_bp), max(abs(temp_pwl(in_range)-temp_ref))/10);
+fprintf("old: %d bytes, max error %.2f C\n", 2*numel(temp_old), max(abs(temp_old(in_range)-temp_ref))/10);
+
+plot(ADC_Val, temp);
+hold on
+plot(ADC_Val_2, temp_pwl/10, 'r');
+
+f=fopen('../Core/Inc/constant.h', 'w');
+fprintf(f, "/*\n * constant.h\n *\n *  Generated by Matlab/ntc_pwl.m from Matlab/ntc.csv, do not edit.\n */\n\n");
+fprintf(f, "#ifndef INC_CONSTANT_H_\n#define INC_CONSTANT_H_\n\n");
+fprintf(f, "#define NTC_ADC_BITS %d\n#define NTC_PWL_SHIFT %d\n\n", ADC_bit_word_size, PWL_shift);
+fprintf(f, "/* NTC temperature in 0.1 C at every 2^NTC_PWL_SHIFT-th ADC code */\n");
+fprintf(f, "static const int16_t ntc_pwl_temp[] = {");
+for k=1:numel(temp_bp)
+  if mod(k-1, 12)==0
+    fprintf(f, "\n\t\t");
+  end
+  fprintf(f, "%d, ", temp_bp(k));
+end
+fprintf(f, "};\n\n#endif /* INC_CONSTANT_H_ */\n");
+fclose(f);
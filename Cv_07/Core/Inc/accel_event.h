@@ -0,0 +1,41 @@
+/*
+ * accel_event.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+
+#ifndef ACCEL_EVENT_H_
+#define ACCEL_EVENT_H_
+
+#include <stdint.h>
+#include "lis2dw12_reg.h"
+
+/* The LIS2DW12 embedded engines (tap, free-fall, 6D, wake-up and the
+ * activity/inactivity detector) all share INT1 with the FIFO threshold,
+ * latched until ALL_INT_SRC is read. The tap engine wants ODR >= 400 Hz,
+ * the times below are at that rate. */
+#define ACCEL_TAP_THS 12 // FS / 32 per LSB, 750 mg at 2 g;
+#define ACCEL_TAP_SHOCK 3 // 8 / ODR per LSB, 60 ms;
+#define ACCEL_TAP_QUIET 3 // 4 / ODR per LSB, 30 ms;
+#define ACCEL_TAP_LATENCY 7 // 32 / ODR per LSB, 560 ms;
+#define ACCEL_FF_DUR 12 // 1 / ODR per LSB, 30 ms;
+#define ACCEL_WU_THS 2 // FS / 64 per LSB, 62.5 mg at 2 g;
+#define ACCEL_SLEEP_DUR 4 // 512 / ODR per LSB, 5 s still and the part drops to 12.5 Hz;
+#define ACCEL_6D_THS 2 // 60 deg;
+
+/* Event bits as delivered in task notifications, bit 0 is left free
+ * for the FIFO threshold */
+#define ACCEL_EVT_TAP       (1UL << 1)
+#define ACCEL_EVT_DTAP      (1UL << 2)
+#define ACCEL_EVT_FF        (1UL << 3)
+#define ACCEL_EVT_WAKE      (1UL << 4)
+#define ACCEL_EVT_6D        (1UL << 5)
+#define ACCEL_EVT_SLEEP     (1UL << 6) // board went still;
+#define ACCEL_EVT_ACTIVE    (1UL << 7) // and moves again;
+#define ACCEL_EVT_ALL       (0xFEUL)
+
+int32_t accel_event_config(stmdev_ctx_t *ctx);
+int32_t accel_event_read(stmdev_ctx_t *ctx, uint32_t *events, uint8_t *orient);
+
+#endif /* ACCEL_EVENT_H_ */
@@ -0,0 +1,29 @@
+/*
+ * i2c_bus.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+
+#ifndef I2C_BUS_H_
+#define I2C_BUS_H_
+
+#include <stdint.h>
+#include "main.h"
+
+/* One task owns the I2C peripheral and runs queued register transfers
+ * with interrupts. Callers block on their task notification until their
+ * transfer is done, other drivers' requests simply queue behind it. */
+#define I2C_BUS_QUEUE_LEN 4
+#define I2C_BUS_TIMEOUT 100 // ms per transfer;
+#define I2C_BUS_STACK 96
+
+/* Notification bit used to wake the caller. Other bits of the caller's
+ * notification value are left pending for its own use. */
+#define I2C_BUS_NOTIFY (1UL << 31)
+
+void i2c_bus_init(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef i2c_bus_read(uint16_t dev, uint8_t reg, uint8_t *buf, uint16_t len);
+HAL_StatusTypeDef i2c_bus_write(uint16_t dev, uint8_t reg, const uint8_t *buf, uint16_t len);
+
+#endif /* I2C_BUS_H_ */
@@ -81,6 +81,9 @@ void Error_Handler(void);
 #define SCT_SDI_GPIO_Port GPIOB
 #define SCT_NLA_Pin GPIO_PIN_5
 #define SCT_NLA_GPIO_Port GPIOB
+#define ACC_INT1_Pin GPIO_PIN_6
+#define ACC_INT1_GPIO_Port GPIOB
+#define ACC_INT1_EXTI_IRQn EXTI4_15_IRQn
 /* USER CODE BEGIN Private defines */
 
 /* USER CODE END Private defines */
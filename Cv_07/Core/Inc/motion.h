@@ -0,0 +1,34 @@
+/*
+ * motion.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+
+#ifndef MOTION_H_
+#define MOTION_H_
+
+#include <stdint.h>
+
+/* Features of one window of LIS2DW12 samples, integer arithmetic only.
+ * Raw data are left aligned 14-bit, everything below is in 14-bit LSB
+ * (0.244 mg at 2 g full scale) unless said otherwise. */
+#define MOTION_ZC_HYST 16 // LSB around the mean a crossing has to clear;
+
+typedef struct {
+	uint32_t time; // kernel tick of the last sample, ms;
+	int16_t mean[3];
+	uint16_t rms[3]; // of (x - mean), i.e. the vibration part;
+	uint16_t p2p[3];
+	int16_t pitch; // 0.1 deg, from the window mean;
+	int16_t roll; // 0.1 deg;
+	uint8_t zc[3]; // zero crossings of (x - mean) in the window;
+	uint8_t n; // samples in the window;
+} motion_feat_t;
+
+void motion_features(const int16_t xyz[][3], uint8_t n, uint32_t time, motion_feat_t *f);
+
+int16_t motion_atan2(int32_t y, int32_t x);
+uint16_t motion_sqrt(uint32_t x);
+
+#endif /* MOTION_H_ */
@@ -11,6 +11,12 @@
 void sct_init(void);
 void sct_led(uint32_t led);
 void sct_value(uint16_t value, uint16_t led);
+/* Frame builders for sct_show(): signed decimal with dp digits after the
+ * point (out of range shows "---"), and the low 12 bits as hex */
+uint32_t sct_format_dec(int16_t value, uint8_t dp);
+uint32_t sct_format_hex(uint16_t value);
+/* Shifts the frame out only when it differs from the one on the display */
+void sct_show(uint32_t frame, uint16_t led);
 
 
 #endif /* SCT_H_ */
@@ -48,7 +48,9 @@
 /* Exported functions prototypes ---------------------------------------------*/
 void NMI_Handler(void);
 void HardFault_Handler(void);
+void EXTI4_15_IRQHandler(void);
 void TIM14_IRQHandler(void);
+void I2C1_IRQHandler(void);
 /* USER CODE BEGIN EFP */
 
 /* USER CODE END EFP */
@@ -0,0 +1,35 @@
+/*
+ * telemetry.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+
+/* Accelerometer frames on the UART, all fields little endian:
+ *
+ *   A5 5A | seq u16 | time u32 | n u8 | n x (X, Y, Z) i16 | crc u16
+ *
+ * seq counts frames so the host sees every lost one, time is the kernel
+ * tick in ms when the block was read, i.e. the time of its last sample.
+ * crc is CRC-16/CCITT-FALSE (0x1021, init 0xFFFF) over seq .. last sample.
+ * Matlab/telemetry_rec.m decodes and records the stream. */
+#define TELEMETRY_SYNC0 0xA5
+#define TELEMETRY_SYNC1 0x5A
+#define TELEMETRY_MAX_SAMPLES 32
+
+/* 1 brings back the "X=.. Y=.. Z=.." text lines for debugging */
+#ifndef TELEMETRY_TEXT
+#define TELEMETRY_TEXT 0
+#endif
+
+/* Queues one frame without waiting, returns 0 when the UART ring had no
+ * room and the frame was dropped */
+uint8_t telemetry_send(const int16_t xyz[][3], uint8_t n, uint32_t time);
+uint32_t telemetry_dropped(void);
+
+#endif /* TELEMETRY_H_ */
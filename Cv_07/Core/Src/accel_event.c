@@ -0,0 +1,71 @@
+/*
+ * accel_event.c
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+#include "accel_event.h"
+
+/* Expects the ODR and power mode already set, keeps int1_fth routing */
+int32_t accel_event_config(stmdev_ctx_t *ctx) {
+	lis2dw12_ctrl4_int1_pad_ctrl_t int1;
+	lis2dw12_ctrl5_int2_pad_ctrl_t int2 = { 0 };
+	int32_t ret;
+
+	ret = lis2dw12_tap_threshold_x_set(ctx, ACCEL_TAP_THS);
+	ret |= lis2dw12_tap_threshold_y_set(ctx, ACCEL_TAP_THS);
+	ret |= lis2dw12_tap_threshold_z_set(ctx, ACCEL_TAP_THS);
+	ret |= lis2dw12_tap_detection_on_x_set(ctx, PROPERTY_ENABLE);
+	ret |= lis2dw12_tap_detection_on_y_set(ctx, PROPERTY_ENABLE);
+	ret |= lis2dw12_tap_detection_on_z_set(ctx, PROPERTY_ENABLE);
+	ret |= lis2dw12_tap_axis_priority_set(ctx, LIS2DW12_ZYX);
+	ret |= lis2dw12_tap_shock_set(ctx, ACCEL_TAP_SHOCK);
+	ret |= lis2dw12_tap_quiet_set(ctx, ACCEL_TAP_QUIET);
+	ret |= lis2dw12_tap_dur_set(ctx, ACCEL_TAP_LATENCY);
+	ret |= lis2dw12_tap_mode_set(ctx, LIS2DW12_BOTH_SINGLE_DOUBLE);
+
+	ret |= lis2dw12_ff_threshold_set(ctx, LIS2DW12_FF_TSH_10LSb_FS2g);
+	ret |= lis2dw12_ff_dur_set(ctx, ACCEL_FF_DUR);
+	ret |= lis2dw12_6d_threshold_set(ctx, ACCEL_6D_THS);
+
+	ret |= lis2dw12_wkup_threshold_set(ctx, ACCEL_WU_THS);
+	ret |= lis2dw12_wkup_dur_set(ctx, 0);
+	ret |= lis2dw12_act_sleep_dur_set(ctx, ACCEL_SLEEP_DUR);
+	ret |= lis2dw12_act_mode_set(ctx, LIS2DW12_DETECT_ACT_INACT);
+
+	ret |= lis2dw12_int_notification_set(ctx, LIS2DW12_INT_LATCHED);
+	ret |= lis2dw12_pin_int1_route_get(ctx, &int1);
+	int1.int1_tap = PROPERTY_ENABLE;
+	int1.int1_single_tap = PROPERTY_ENABLE;
+	int1.int1_ff = PROPERTY_ENABLE;
+	int1.int1_wu = PROPERTY_ENABLE;
+	int1.int1_6d = PROPERTY_ENABLE;
+	ret |= lis2dw12_pin_int1_route_set(ctx, &int1);
+	int2.int2_sleep_chg = PROPERTY_ENABLE; // sleep change can only go to INT2, fold it onto INT1;
+	ret |= lis2dw12_pin_int2_route_set(ctx, &int2);
+	ret |= lis2dw12_all_on_int1_set(ctx, PROPERTY_ENABLE);
+	return ret;
+}
+
+/* One 5 byte read of STATUS_DUP .. ALL_INT_SRC, which also releases the
+ * latched INT1. orient gets the 6D source bits (xl xh yl yh zl zh). */
+int32_t accel_event_read(stmdev_ctx_t *ctx, uint32_t *events, uint8_t *orient) {
+	lis2dw12_all_sources_t src;
+	uint32_t ev = 0;
+	int32_t ret;
+
+	*events = 0;
+	if ((ret = lis2dw12_all_sources_get(ctx, &src)) != 0) return ret;
+
+	if (src.all_int_src.single_tap) ev |= ACCEL_EVT_TAP;
+	if (src.all_int_src.double_tap) ev |= ACCEL_EVT_DTAP;
+	if (src.all_int_src.ff_ia) ev |= ACCEL_EVT_FF;
+	if (src.all_int_src.wu_ia) ev |= ACCEL_EVT_WAKE;
+	if (src.all_int_src._6d_ia) ev |= ACCEL_EVT_6D;
+	if (src.all_int_src.sleep_change_ia) {
+		ev |= src.wake_up_src.sleep_state_ia ? ACCEL_EVT_SLEEP : ACCEL_EVT_ACTIVE;
+	}
+	*orient = *(uint8_t*) &src.sixd_src & 0x3F;
+	*events = ev;
+	return 0;
+}
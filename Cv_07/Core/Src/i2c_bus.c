@@ -0,0 +1,108 @@
+/*
+ * i2c_bus.c
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+#include "cmsis_os.h"
+#include "i2c_bus.h"
+
+typedef struct {
+	uint16_t dev;
+	uint8_t reg;
+	uint8_t write;
+	uint8_t *buf;
+	uint16_t len;
+	HAL_StatusTypeDef status;
+	TaskHandle_t waiter;
+} i2c_bus_req_t;
+
+static I2C_HandleTypeDef *bus_i2c;
+static QueueHandle_t bus_queue;
+static TaskHandle_t bus_task;
+static volatile HAL_StatusTypeDef bus_status;
+
+static void i2c_bus_done(HAL_StatusTypeDef status) {
+	BaseType_t woken = pdFALSE;
+
+	bus_status = status;
+	vTaskNotifyGiveFromISR(bus_task, &woken);
+	portYIELD_FROM_ISR(woken);
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+	if (hi2c == bus_i2c) i2c_bus_done(HAL_OK);
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c) {
+	if (hi2c == bus_i2c) i2c_bus_done(HAL_OK);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+	if (hi2c == bus_i2c) i2c_bus_done(HAL_ERROR);
+}
+
+static HAL_StatusTypeDef i2c_bus_transfer(i2c_bus_req_t *req) {
+	HAL_StatusTypeDef status;
+
+	ulTaskNotifyTake(pdTRUE, 0); // drop a late completion of a timed out transfer;
+	if (req->write) {
+		status = HAL_I2C_Mem_Write_IT(bus_i2c, req->dev, req->reg, I2C_MEMADD_SIZE_8BIT, req->buf, req->len);
+	} else {
+		status = HAL_I2C_Mem_Read_IT(bus_i2c, req->dev, req->reg, I2C_MEMADD_SIZE_8BIT, req->buf, req->len);
+	}
+	if (status != HAL_OK) return status;
+
+	if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(I2C_BUS_TIMEOUT)) == 0) {
+		HAL_I2C_DeInit(bus_i2c); // stuck bus, start the peripheral over;
+		HAL_I2C_Init(bus_i2c);
+		return HAL_TIMEOUT;
+	}
+	return bus_status;
+}
+
+static void i2c_bus_thread(void const *argument) {
+	i2c_bus_req_t *req;
+
+	for (;;) {
+		if (xQueueReceive(bus_queue, &req, portMAX_DELAY) != pdTRUE) continue;
+		req->status = i2c_bus_transfer(req);
+		xTaskNotify(req->waiter, I2C_BUS_NOTIFY, eSetBits);
+	}
+}
+
+void i2c_bus_init(I2C_HandleTypeDef *hi2c) {
+	bus_i2c = hi2c;
+	bus_queue = xQueueCreate(I2C_BUS_QUEUE_LEN, sizeof(i2c_bus_req_t *));
+	osThreadDef(I2CBusTask, i2c_bus_thread, osPriorityAboveNormal, 0, I2C_BUS_STACK);
+	bus_task = osThreadCreate(osThread(I2CBusTask), NULL);
+}
+
+static HAL_StatusTypeDef i2c_bus_submit(i2c_bus_req_t *req) {
+	uint32_t bits, other = 0;
+
+	if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING) { // init code before osKernelStart;
+		if (req->write)
+			return HAL_I2C_Mem_Write(bus_i2c, req->dev, req->reg, I2C_MEMADD_SIZE_8BIT, req->buf, req->len, I2C_BUS_TIMEOUT);
+		return HAL_I2C_Mem_Read(bus_i2c, req->dev, req->reg, I2C_MEMADD_SIZE_8BIT, req->buf, req->len, I2C_BUS_TIMEOUT);
+	}
+	req->waiter = xTaskGetCurrentTaskHandle();
+	xQueueSend(bus_queue, &req, portMAX_DELAY);
+	do {
+		xTaskNotifyWait(0, I2C_BUS_NOTIFY, &bits, portMAX_DELAY);
+		other |= bits & ~I2C_BUS_NOTIFY;
+	} while (!(bits & I2C_BUS_NOTIFY));
+	if (other)
+		xTaskNotify(req->waiter, 0, eNoAction); // keep the caller's own events pending;
+	return req->status;
+}
+
+HAL_StatusTypeDef i2c_bus_read(uint16_t dev, uint8_t reg, uint8_t *buf, uint16_t len) {
+	i2c_bus_req_t req = { dev, reg, 0, buf, len };
+	return i2c_bus_submit(&req);
+}
+
+HAL_StatusTypeDef i2c_bus_write(uint16_t dev, uint8_t reg, const uint8_t *buf, uint16_t len) {
+	i2c_bus_req_t req = { dev, reg, 1, (uint8_t*) buf, len };
+	return i2c_bus_submit(&req);
+}
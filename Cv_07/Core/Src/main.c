@@ -25,6 +25,11 @@
 #include "lis2dw12_reg.h"
 #include "sct.h"
 #include <stdio.h>
+#include "uart_tx.h"
+#include "i2c_bus.h"
+#include "telemetry.h"
+#include "motion.h"
+#include "accel_event.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -34,6 +39,11 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+#define ACC_ODR LIS2DW12_XL_ODR_400Hz // tap detection needs 400 Hz;
+#define ACC_ODR_HZ 400 // odr in Matlab/telemetry_rec.m has to match;
+#define ACC_FIFO_FTH 16 // INT1 fires once this many samples wait in the FIFO;
+#define ACC_FIFO_DEPTH 32
+#define ACC_NOTIFY_FTH (1UL << 0)
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -51,7 +61,8 @@ osThreadId VisualTaskHandle;
 osThreadId AcceleroTaskHandle;
 osMessageQId xVisualQueueHandle;
 /* USER CODE BEGIN PV */
-
+static int16_t acc_fifo[ACC_FIFO_DEPTH][3];
+static volatile uint8_t acc_orient; // 6D source bits of the last event;
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -111,6 +122,8 @@ int main(void)
   MX_USART2_UART_Init();
   MX_I2C1_Init();
   /* USER CODE BEGIN 2 */
+  uart_tx_init();
+  i2c_bus_init(&hi2c1);
 
   /* USER CODE END 2 */
 
@@ -128,7 +141,7 @@ int main(void)
 
   /* Create the queue(s) */
   /* definition and creation of xVisualQueue */
-  osMessageQDef(xVisualQueue, 16, uint16_t);
+  osMessageQDef(xVisualQueue, 4, motion_feat_t);
   xVisualQueueHandle = osMessageCreate(osMessageQ(xVisualQueue), NULL);
 
   /* USER CODE BEGIN RTOS_QUEUES */
@@ -341,22 +354,85 @@ static void MX_GPIO_Init(void)
   GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
   HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
 
+  /*Configure GPIO pin : ACC_INT1_Pin */
+  GPIO_InitStruct.Pin = ACC_INT1_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  HAL_GPIO_Init(ACC_INT1_GPIO_Port, &GPIO_InitStruct);
+
+  /* EXTI interrupt init*/
+  HAL_NVIC_SetPriority(EXTI4_15_IRQn, 3, 0);
+  HAL_NVIC_EnableIRQ(EXTI4_15_IRQn);
+
 }
 
 /* USER CODE BEGIN 4 */
+/* bus errors come back to the lis2dw12 driver as a nonzero return */
 static int32_t platform_write(void *handle, uint8_t reg, const uint8_t *bufp, uint16_t len) {
-	HAL_I2C_Mem_Write(handle, LIS2DW12_I2C_ADD_H, reg, I2C_MEMADD_SIZE_8BIT, (uint8_t*)bufp, len, 1000);
-	return 0;
-
+	return i2c_bus_write(LIS2DW12_I2C_ADD_H, reg, bufp, len);
 }
 static int32_t platform_read(void *handle, uint8_t reg, uint8_t *bufp, uint16_t len) {
-	HAL_I2C_Mem_Read(handle, LIS2DW12_I2C_ADD_H, reg, I2C_MEMADD_SIZE_8BIT, bufp, len, 1000);
-	return 0;
+	return i2c_bus_read(LIS2DW12_I2C_ADD_H, reg, bufp, len);
+}
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+	BaseType_t woken = pdFALSE;
+
+	if (GPIO_Pin != ACC_INT1_Pin || AcceleroTaskHandle == NULL) return;
+	xTaskNotifyFromISR(AcceleroTaskHandle, ACC_NOTIFY_FTH, eSetBits, &woken);
+	portYIELD_FROM_ISR(woken);
 }
+
+static int32_t acc_config(void)
+{
+	lis2dw12_ctrl4_int1_pad_ctrl_t int1 = { 0 };
+	uint8_t id, rst;
+	int32_t ret;
+
+	if ((ret = lis2dw12_device_id_get(&lis2dw12, &id)) != 0) return ret;
+	if (id != LIS2DW12_ID) return -1;
+	lis2dw12_reset_set(&lis2dw12, PROPERTY_ENABLE); // INT1 may still be routed from before an MCU reset;
+	do {
+		if ((ret = lis2dw12_reset_get(&lis2dw12, &rst)) != 0) return ret;
+	} while (rst);
+
+	ret = lis2dw12_full_scale_set(&lis2dw12, LIS2DW12_2g);
+	ret |= lis2dw12_power_mode_set(&lis2dw12, LIS2DW12_HIGH_PERFORMANCE);
+	ret |= lis2dw12_block_data_update_set(&lis2dw12, PROPERTY_ENABLE);
+	ret |= lis2dw12_auto_increment_set(&lis2dw12, PROPERTY_ENABLE);
+	ret |= lis2dw12_fifo_watermark_set(&lis2dw12, ACC_FIFO_FTH);
+	ret |= lis2dw12_fifo_mode_set(&lis2dw12, LIS2DW12_STREAM_MODE); // enable continuous FIFO
+	int1.int1_fth = PROPERTY_ENABLE;
+	ret |= lis2dw12_pin_int1_route_set(&lis2dw12, &int1);
+	ret |= accel_event_config(&lis2dw12);
+	ret |= lis2dw12_data_rate_set(&lis2dw12, ACC_ODR); // enable part from power-down
+	return ret;
+}
+
+/* Still board: the part runs at 12.5 Hz, stop the FIFO so only a wake-up
+ * event raises INT1 */
+static void acc_stream(uint8_t on)
+{
+	lis2dw12_fifo_mode_set(&lis2dw12, on ? LIS2DW12_STREAM_MODE : LIS2DW12_BYPASS_MODE);
+}
+
+/* The whole FIFO content in one transfer: with the FIFO enabled the address
+ * rolls over from OUT_Z_H back to OUT_X_L, so 6 * n bytes pop n samples. */
+static uint8_t acc_fifo_drain(void)
+{
+	uint8_t samples;
+
+	if (lis2dw12_fifo_data_level_get(&lis2dw12, &samples) != 0) return 0;
+	if (samples > ACC_FIFO_DEPTH) samples = ACC_FIFO_DEPTH;
+	if (samples == 0) return 0;
+	if (lis2dw12_read_reg(&lis2dw12, LIS2DW12_OUT_X_L, (uint8_t*) acc_fifo, 6 * samples) != 0) return 0;
+	return samples;
+}
+
 int _write(int file, char const *buf, int n)
 {
  /* stdout redirection to UART2 */
-	HAL_UART_Transmit(&huart2, (uint8_t*)(buf), n, HAL_MAX_DELAY);
+	uart_tx_write((const uint8_t*)buf, n);
 	return n;
 }
 
@@ -375,8 +451,23 @@ void StartDefaultTask(void const * argument)
   /* Infinite loop */
   for(;;)
   {
-
-	  osDelay(1);
+	  uint32_t events;
+
+	  // accelerometer events from AcceleroTask, nothing to do in between;
+	  xTaskNotifyWait(0, ACCEL_EVT_ALL, &events, portMAX_DELAY);
+
+	  if (events & ACCEL_EVT_TAP) HAL_GPIO_TogglePin(LD2_GPIO_Port, LD2_Pin);
+	  if (events & ACCEL_EVT_DTAP) HAL_GPIO_WritePin(LD2_GPIO_Port, LD2_Pin, 0);
+	  if (events & ACCEL_EVT_FF) HAL_GPIO_WritePin(LD2_GPIO_Port, LD2_Pin, 1);
+#if TELEMETRY_TEXT
+	  if (events & ACCEL_EVT_TAP) printf("tap\n");
+	  if (events & ACCEL_EVT_DTAP) printf("double tap\n");
+	  if (events & ACCEL_EVT_FF) printf("free fall\n");
+	  if (events & ACCEL_EVT_WAKE) printf("wake up\n");
+	  if (events & ACCEL_EVT_6D) printf("6D %02X\n", acc_orient);
+	  if (events & ACCEL_EVT_SLEEP) printf("still\n");
+	  if (events & ACCEL_EVT_ACTIVE) printf("active\n");
+#endif
   }
   /* USER CODE END 5 */
 }
@@ -394,24 +485,21 @@ void StartVisualTask(void const * argument)
   /* Infinite loop */
   for(;;)
   {
-	  int16_t msg;
-	  if (xQueueReceive(xVisualQueueHandle, &msg, portMAX_DELAY)) {
-		  if(msg<-1000){
+	  motion_feat_t feat;
+	  if (xQueueReceive(xVisualQueueHandle, &feat, portMAX_DELAY)) {
+		  // +-1000 raw X used to be about +-3.5 deg of pitch;
+		  if(feat.pitch>35){
 			  HAL_GPIO_WritePin(LED1_GPIO_Port, LED1_Pin, 0); //light up  LED1
-		  }else
-		  if(msg>-1000){
+		  }else{
 			  HAL_GPIO_WritePin(LED1_GPIO_Port, LED1_Pin, 1); //light down  LED1
 		  }
 
-		  if(msg>1000){
+		  if(feat.pitch<-35){
 			  HAL_GPIO_WritePin(LED2_GPIO_Port, LED2_Pin, 0); //light up  LED2
-		  }else
-		  if(msg<1000){
+		  }else{
 			  HAL_GPIO_WritePin(LED2_GPIO_Port, LED2_Pin, 1); //light down  LED2
 		  }
 	  }
-
-    osDelay(100);
   }
   /* USER CODE END StartVisualTask */
 }
@@ -426,27 +514,47 @@ void StartVisualTask(void const * argument)
 void StartAcceleroTask(void const * argument)
 {
   /* USER CODE BEGIN StartAcceleroTask */
+  while (acc_config() != 0) {
+	  printf("LIS2DW12 not responding\n");
+	  osDelay(1000);
+  }
+
+  uint8_t still = 0;
+
   /* Infinite loop */
   for(;;)
   {
+	  uint32_t bits, events;
+	  uint8_t orient;
 
-	  lis2dw12_full_scale_set(&lis2dw12, LIS2DW12_2g);
-	  lis2dw12_power_mode_set(&lis2dw12, LIS2DW12_CONT_LOW_PWR_LOW_NOISE_2);
-	  lis2dw12_block_data_update_set(&lis2dw12, PROPERTY_ENABLE);
-	  lis2dw12_fifo_mode_set(&lis2dw12, LIS2DW12_STREAM_MODE); // enable continuous FIFO
-	  lis2dw12_data_rate_set(&lis2dw12, LIS2DW12_XL_ODR_25Hz); // enable part from power-down
-
-	  uint8_t samples;
-	  int16_t raw_acceleration[3];
-	  lis2dw12_fifo_data_level_get(&lis2dw12, &samples);
-	  for (uint8_t i = 0; i < samples; i++) {
-	   // Read acceleration data
-	   lis2dw12_acceleration_raw_get(&lis2dw12, raw_acceleration);
-	   printf("X=%d Y=%d Z=%d\n", raw_acceleration[0], raw_acceleration[1], raw_acceleration[2]);
+	  // INT1 still high means the FIFO refilled past threshold or an event is latched, no new edge comes;
+	  if (HAL_GPIO_ReadPin(ACC_INT1_GPIO_Port, ACC_INT1_Pin) == GPIO_PIN_RESET)
+		  xTaskNotifyWait(0, ACC_NOTIFY_FTH, &bits, still ? portMAX_DELAY : pdMS_TO_TICKS(1000 * ACC_FIFO_DEPTH / ACC_ODR_HZ));
+
+	  if (accel_event_read(&lis2dw12, &events, &orient) == 0 && events) {
+		  if (events & ACCEL_EVT_SLEEP) {
+			  still = 1;
+			  acc_stream(0);
+		  }
+		  if (events & ACCEL_EVT_ACTIVE) {
+			  still = 0;
+			  acc_stream(1);
+		  }
+		  acc_orient = orient;
+		  xTaskNotify(defaultTaskHandle, events, eSetBits);
 	  }
+	  if (still) continue;
+
+	  uint8_t samples = acc_fifo_drain();
+	  if (samples == 0) continue;
+	  uint32_t now = osKernelSysTick();
+	  telemetry_send(acc_fifo, samples, now);
+
+	  motion_feat_t feat;
+	  motion_features(acc_fifo, samples, now, &feat);
+	  xQueueSend(xVisualQueueHandle, &feat, 0);  // one summary per FIFO window to the visual task
 
-	  xQueueSend(xVisualQueueHandle, &raw_acceleration[0], 0);  // Send x-axis acceleration data to visual led function
-		osDelay(100);
+	  int16_t *raw_acceleration = acc_fifo[samples - 1];
 		uint8_t raw_z = raw_acceleration[1]>>8;
 		uint8_t raw_y = raw_acceleration[2]>>8;
 		sct_value(raw_z/10, raw_y/10);
@@ -0,0 +1,93 @@
+/*
+ * motion.c
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+#include "motion.h"
+
+#define MOTION_SHIFT 2 // 16-bit raw to 14-bit, keeps a 32 sample sum of squares in 31 bits;
+
+/* Bit by bit integer square root, floor(sqrt(x)) */
+uint16_t motion_sqrt(uint32_t x) {
+	uint32_t r = 0;
+	uint32_t bit = 1UL << 30;
+
+	while (bit > x) bit >>= 2;
+	while (bit) {
+		if (x >= r + bit) {
+			x -= r + bit;
+			r = (r >> 1) + bit;
+		} else {
+			r >>= 1;
+		}
+		bit >>= 2;
+	}
+	return r;
+}
+
+/* atan(r) for r = min / max in Q15, 0.1 deg. atan(r) ~ 45 r + 15.64 r (1 - r)
+ * in degrees, off by less than 0.3 deg. (t >> 8) * r stays below 2^32. */
+static uint16_t motion_atan_q15(uint32_t r) {
+	uint32_t t = (450UL << 15) + 156UL * (32768 - r);
+	return ((t >> 8) * r + (1UL << 21)) >> 22;
+}
+
+/* Angle of (x, y) in 0.1 deg, -1800 .. 1800, |x|, |y| < 2^16 */
+int16_t motion_atan2(int32_t y, int32_t x) {
+	uint32_t ax = x < 0 ? -x : x;
+	uint32_t ay = y < 0 ? -y : y;
+	int16_t a;
+
+	if (ax == 0 && ay == 0) return 0;
+	if (ay <= ax) {
+		a = motion_atan_q15((ay << 15) / ax);
+	} else {
+		a = 900 - motion_atan_q15((ax << 15) / ay);
+	}
+	if (x < 0) a = 1800 - a;
+	return y < 0 ? -a : a;
+}
+
+void motion_features(const int16_t xyz[][3], uint8_t n, uint32_t time, motion_feat_t *f) {
+	f->time = time;
+	f->n = n;
+	if (n == 0) return;
+
+	for (uint8_t k = 0; k < 3; k++) {
+		int32_t sum = 0;
+		int16_t lo = INT16_MAX, hi = INT16_MIN;
+
+		for (uint8_t i = 0; i < n; i++) {
+			int16_t v = xyz[i][k] >> MOTION_SHIFT;
+			sum += v;
+			if (v < lo) lo = v;
+			if (v > hi) hi = v;
+		}
+		int16_t mean = sum / n;
+
+		uint32_t sq = 0;
+		uint8_t zc = 0;
+		int8_t side = 0; // which side of the band around the mean we were last seen on;
+		for (uint8_t i = 0; i < n; i++) {
+			int32_t d = (xyz[i][k] >> MOTION_SHIFT) - mean;
+			sq += d * d;
+			if (d > MOTION_ZC_HYST) {
+				if (side < 0) zc++;
+				side = 1;
+			} else if (d < -MOTION_ZC_HYST) {
+				if (side > 0) zc++;
+				side = -1;
+			}
+		}
+
+		f->mean[k] = mean;
+		f->rms[k] = motion_sqrt(sq / n);
+		f->p2p[k] = hi - lo;
+		f->zc[k] = zc;
+	}
+
+	int32_t yz = motion_sqrt((int32_t) f->mean[1] * f->mean[1] + (int32_t) f->mean[2] * f->mean[2]);
+	f->pitch = motion_atan2(-f->mean[0], yz);
+	f->roll = motion_atan2(f->mean[1], f->mean[2]);
+}
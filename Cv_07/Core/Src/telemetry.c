@@ -0,0 +1,76 @@
+/*
+ * telemetry.c
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+#include <stdio.h>
+#include "telemetry.h"
+#include "uart_tx.h"
+
+#define TELEMETRY_HEAD 9
+#define TELEMETRY_FRAME_MAX (TELEMETRY_HEAD + 6 * TELEMETRY_MAX_SAMPLES + 2)
+
+static uint16_t telemetry_seq;
+static uint32_t telemetry_lost;
+
+#if !TELEMETRY_TEXT
+static uint8_t telemetry_frame[TELEMETRY_FRAME_MAX];
+
+/* CRC-16/CCITT one nibble at a time, 16 entry table */
+static const uint16_t telemetry_crc_tab[16] = {
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+static uint16_t telemetry_crc(const uint8_t *buf, uint16_t len) {
+	uint16_t crc = 0xFFFF;
+	for (uint16_t i = 0; i < len; i++) {
+		crc = (crc << 4) ^ telemetry_crc_tab[(crc >> 12) ^ (buf[i] >> 4)];
+		crc = (crc << 4) ^ telemetry_crc_tab[(crc >> 12) ^ (buf[i] & 0x0F)];
+	}
+	return crc;
+}
+
+static uint8_t *put16(uint8_t *p, uint16_t v) {
+	p[0] = v;
+	p[1] = v >> 8;
+	return p + 2;
+}
+#endif
+
+uint8_t telemetry_send(const int16_t xyz[][3], uint8_t n, uint32_t time) {
+	if (n > TELEMETRY_MAX_SAMPLES) n = TELEMETRY_MAX_SAMPLES;
+#if TELEMETRY_TEXT
+	for (uint8_t i = 0; i < n; i++) {
+		printf("X=%d Y=%d Z=%d\n", xyz[i][0], xyz[i][1], xyz[i][2]);
+	}
+	telemetry_seq++;
+	return 1;
+#else
+	uint8_t *p = telemetry_frame;
+
+	*p++ = TELEMETRY_SYNC0;
+	*p++ = TELEMETRY_SYNC1;
+	p = put16(p, telemetry_seq++);
+	p = put16(p, time);
+	p = put16(p, time >> 16);
+	*p++ = n;
+	for (uint8_t i = 0; i < n; i++) {
+		p = put16(p, xyz[i][0]);
+		p = put16(p, xyz[i][1]);
+		p = put16(p, xyz[i][2]);
+	}
+	p = put16(p, telemetry_crc(&telemetry_frame[2], p - &telemetry_frame[2]));
+
+	if (!uart_tx_write_all(telemetry_frame, p - telemetry_frame)) {
+		telemetry_lost++;
+		return 0;
+	}
+	return 1;
+#endif
+}
+
+uint32_t telemetry_dropped(void) {
+	return telemetry_lost;
+}
@@ -0,0 +1,90 @@
+clear all;
+% Records the accelerometer frames sent by telemetry_send() in Core/Src/telemetry.c
+% A5 5A | seq u16 | time u32 | n u8 | n x (X, Y, Z) i16 | crc u16, little endian
+
+port="COM3";
+baud=38400; % has to match huart2.Init.BaudRate
+duration=30; % s
+odr=400; % Hz, ACC_ODR_HZ in Core/Src/main.c
+out="accel.csv";
+
+s=serialport(port, baud);
+flush(s);
+
+buf=uint8([]);
+rows=zeros(0, 5); % seq, time [ms], X, Y, Z
+frames=0; bad=0; lost=0; last_seq=-1;
+
+tic;
+while toc < duration
+    if s.NumBytesAvailable > 0
+        buf=[buf; read(s, s.NumBytesAvailable, "uint8")'];
+    else
+        pause(0.01);
+    end
+
+    % resync on A5 5A, a frame only counts when its crc matches
+    while numel(buf) >= 11
+        k=find(buf(1:end-1) == 165 & buf(2:end) == 90, 1);
+        if isempty(k)
+            buf=buf(end);
+            break;
+        end
+        buf=buf(k:end);
+        if numel(buf) < 9
+            break;
+        end
+        n=double(buf(9));
+        len=9+6*n+2;
+        if n > 32
+            buf=buf(2:end); bad=bad+1;
+            continue;
+        end
+        if numel(buf) < len
+            break;
+        end
+        frame=buf(1:len);
+        crc=double(typecast(frame(len-1:len), "uint16"));
+        if crc ~= crc16(frame(3:len-2))
+            buf=buf(2:end); bad=bad+1;
+            continue;
+        end
+        buf=buf(len+1:end);
+
+        seq=double(typecast(frame(3:4), "uint16"));
+        t=double(typecast(frame(5:8), "uint32"));
+        xyz=reshape(double(typecast(frame(10:len-2), "int16")), 3, n)';
+        if last_seq >= 0
+            lost=lost+mod(seq-last_seq-1, 65536);
+        end
+        last_seq=seq;
+        frames=frames+1;
+
+        % time stamps the last sample of the block, the rest go back at 1/odr
+        ts=t-(n-1:-1:0)'*1000/odr;
+        rows=[rows; repmat(seq, n, 1), ts, xyz];
+    end
+end
+clear s;
+
+fprintf("%d frames, %d samples, %d lost frames, %d crc errors\n", frames, size(rows, 1), lost, bad);
+writematrix(rows, out);
+
+plot(rows(:,2)/1000, rows(:,3:5));
+xlabel("t [s]"); ylabel("raw"); legend("X", "Y", "Z");
+
+function crc=crc16(data)
+    % CRC-16/CCITT-FALSE, same as telemetry_crc()
+    crc=uint16(65535);
+    for b=data(:)'
+        crc=bitxor(crc, bitshift(uint16(b), 8));
+        for i=1:8
+            if bitand(crc, 32768)
+                crc=bitxor(bitshift(crc, 1), uint16(4129));
+            else
+                crc=bitshift(crc, 1);
+            end
+        end
+    end
+    crc=double(crc);
+end
@@ -22,6 +22,7 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "stdio.h"
+#include "sched.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -45,6 +46,9 @@ UART_HandleTypeDef huart3;
 
 /* USER CODE BEGIN PV */
 static volatile int8_t key = -1;
+static const uint8_t password[] = {7, 9, 3, 2, 12};
+static uint8_t pos = 0;
+static uint8_t key_hold = 0;
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -105,6 +109,41 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
 }
 
 
+
+static void password_timeout(void) {
+	if (pos != 0) {
+		printf("Timeout\n");
+	}
+	pos = 0;
+}
+
+static void key_release(void) {
+	key_hold = 0;
+	key = -1; // flag for new read
+}
+
+static void keypad_task(void) {
+	if (key == -1 || key_hold) return;
+
+	sched_after(3000, password_timeout); // restart timeout count;
+	if (key == password[pos]) {
+		pos++;
+		printf("Pressed: %d > pos: %d\n", key, pos);
+		if (pos > 4) {
+			HAL_GPIO_TogglePin(LD1_GPIO_Port, LD1_Pin); //toggle led in case of success
+			printf("Toggle LED\n");
+			pos = 0;
+		}
+		key_hold = 1;
+		sched_after(250, key_release); //filter delay
+	}
+	else {
+		printf("FAIL\n");
+		pos = 0;
+		printf("Pressed: %d > pos: %d\n", key, pos);
+		key = -1; // flag for new read
+	}
+}
 /* USER CODE END 0 */
 
 /**
@@ -140,44 +179,14 @@ int main(void)
   /* USER CODE BEGIN 2 */
   HAL_TIM_Base_Start_IT(&htim3);
   printf(" Cv_10 online:\n");
-
-  const uint8_t password[] = {7, 9, 3, 2, 12};
-  uint8_t pos = 0;
-  uint32_t timeout;
+  sched_every(10, keypad_task);
   /* USER CODE END 2 */
 
   /* Infinite loop */
   /* USER CODE BEGIN WHILE */
   while (1)
   {
-
-		if (key != -1) {
-			timeout = HAL_GetTick(); //store time for timeout count
-			if (key == password[pos]) {
-				pos++;
-				printf("Pressed: %d > pos: %d\n", key, pos);
-				HAL_Delay(250); //filter delay
-				if (pos > 4) {
-					HAL_GPIO_TogglePin(LD1_GPIO_Port, LD1_Pin); //toggle led in case of success
-					printf("Toggle LED\n");
-					pos = 0;
-				}
-
-			}
-			else {
-				printf("FAIL\n");
-				pos = 0;
-				printf("Pressed: %d > pos: %d\n", key, pos);
-			}
-		key = -1; // flag for new read
-		}
-		if (HAL_GetTick() > timeout + 3000) {
-
-			if (pos != 0) {
-				printf("Timeout\n");
-			}
-			pos = 0;
-		}
+		sched_run();
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
@@ -0,0 +1,38 @@
+/*
+ * tcpecho.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+
+#ifndef TCPECHO_H_
+#define TCPECHO_H_
+
+#include <stdint.h>
+
+/* An echo connection keeps received frames until the peer ACKs them, and
+ * each one pins a whole ethernetif RX buffer whatever its size. Beyond
+ * TCPECHO_MAX_PINNED of them the data is copied to the heap instead, so
+ * small segments can't drain the RX pool and block the ACKs that would
+ * free it. Two connections pin at most 4 of the 8 buffers outside the
+ * DMA ring. The heap copies are bounded too, past TCPECHO_MAX_CLONED
+ * bytes a connection stops taking data until its echo is ACKed; the two
+ * of them take at most 2 KB of MEM_SIZE. */
+#define TCPECHO_MAX_CONN 4
+#define TCPECHO_MAX_ECHO 2
+#define TCPECHO_MAX_PINNED 2
+#define TCPECHO_MAX_CLONED 1024
+
+typedef struct {
+	uint32_t rx_bytes;
+	uint32_t rx_segs;
+	uint32_t tx_bytes; // ACKed by the peer;
+	uint32_t tx_segs; // zero-copy tcp_write() calls, lwIP may still pack some together;
+	uint32_t accepted;
+	uint32_t refused;
+} tcpecho_stats_t;
+
+void tcpecho_init(void);
+void tcpecho_stats(tcpecho_stats_t *total, tcpecho_stats_t *per_s);
+
+#endif /* TCPECHO_H_ */
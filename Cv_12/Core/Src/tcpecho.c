@@ -33,79 +33,338 @@
 
 #include "lwip/opt.h"
 
-#if LWIP_NETCONN
+#if LWIP_TCP
 
-#include "lwip/sys.h"
-#include "lwip/api.h"
+#include <string.h>
+#include "lwip/tcp.h"
+#include "lwip/tcpip.h"
+#include "tcpecho.h"
 
-#define TCPECHO_THREAD_PRIO  ( tskIDLE_PRIORITY + 4 )
+/* Echo (7), discard (9) and chargen (19) on the raw TCP API. The
+ * callbacks run under the tcpip core lock, in the tcpip thread or, for
+ * received segments, in the ethernetif input thread. Echo is zero-copy: the received pbufs are queued with
+ * tcp_write() without TCP_WRITE_FLAG_COPY and kept until the peer ACKs
+ * them, only then is the receive window reopened with tcp_recved().
+ * Past TCPECHO_MAX_PINNED pool buffers a segment is cloned to PBUF_RAM
+ * first, and when even that fails lwIP holds it and offers it again. */
 
+#define TCPECHO_PORT_ECHO     7
+#define TCPECHO_PORT_DISCARD  9
+#define TCPECHO_PORT_CHARGEN  19
+#define TCPECHO_POLL          2   /* coarse poll, 2 x 500 ms */
 
+#define CHARGEN_LINE          72
+#define CHARGEN_CHARS         95  /* ' ' .. '~' */
 
-/*-----------------------------------------------------------------------------------*/
-static void tcpecho_thread(void *arg)
+enum { SERVICE_ECHO, SERVICE_DISCARD, SERVICE_CHARGEN };
+
+struct tcpecho_conn {
+  struct tcp_pcb *pcb;    /* NULL while the slot is free */
+  u8_t service;
+  u8_t closing;
+  struct pbuf *p;         /* echo: received and not yet ACKed back */
+  u8_t pinned;            /* pbufs of p holding a pool buffer, not heap */
+  u16_t cloned;           /* bytes of p copied to the heap */
+  u16_t acked;            /* bytes of the head pbuf already ACKed */
+  u32_t sent;             /* bytes of the chain given to tcp_write */
+  u8_t line;              /* chargen: next line */
+};
+
+static struct tcpecho_conn tcpecho_conns[TCPECHO_MAX_CONN];
+static tcpecho_stats_t tcpecho_counters;
+static char chargen_lines[CHARGEN_CHARS][CHARGEN_LINE + 2];
+
+static u8_t tcpecho_count(u8_t service)
+{
+  u8_t i, n = 0;
+
+  for (i = 0; i < TCPECHO_MAX_CONN; i++)
+    if (tcpecho_conns[i].pcb != NULL && tcpecho_conns[i].service == service)
+      n++;
+  return n;
+}
+
+/* PBUF_RAM clones come from the heap, anything else holds a pool buffer */
+static u8_t tcpecho_pinned(struct pbuf *p)
+{
+  u8_t n = 0;
+
+  for (; p != NULL; p = p->next)
+    if (pbuf_get_allocsrc(p) != PBUF_TYPE_ALLOC_SRC_MASK_STD_HEAP)
+      n++;
+  return n;
+}
+
+static void tcpecho_release(struct tcpecho_conn *c)
+{
+  if (c->p != NULL)
+    pbuf_free(c->p);
+  memset(c, 0, sizeof(*c));
+}
+
+/* Returns ERR_ABRT when the pcb had to be aborted, callbacks pass it on */
+static err_t tcpecho_close(struct tcpecho_conn *c)
+{
+  struct tcp_pcb *pcb = c->pcb;
+
+  tcp_arg(pcb, NULL);
+  tcp_recv(pcb, NULL);
+  tcp_sent(pcb, NULL);
+  tcp_err(pcb, NULL);
+  tcp_poll(pcb, NULL, 0);
+  tcpecho_release(c);
+  if (tcp_close(pcb) == ERR_OK)
+    return ERR_OK;
+  tcp_abort(pcb);
+  return ERR_ABRT;
+}
+
+/* Queues as much of the unsent part of the chain as the send buffer takes */
+static void tcpecho_echo_send(struct tcpecho_conn *c)
 {
-  struct netconn *conn, *newconn;
-  err_t err, accept_err;
-  struct netbuf *buf;
-  void *data;
+  struct pbuf *q = c->p;
+  u32_t off = c->sent;
   u16_t len;
-      
-  LWIP_UNUSED_ARG(arg);
 
-  /* Create a new connection identifier. */
-  conn = netconn_new(NETCONN_TCP);
-  
-  if (conn!=NULL)
-  {  
-    /* Bind connection to well known port number 7. */
-    err = netconn_bind(conn, NULL, 7);
-    
-    if (err == ERR_OK)
-    {
-      /* Tell connection to go into listening mode. */
-      netconn_listen(conn);
-    
-      while (1) 
-      {
-        /* Grab new connection. */
-         accept_err = netconn_accept(conn, &newconn);
-    
-        /* Process the new connection. */
-        if (accept_err == ERR_OK) 
-        {
-
-          while (netconn_recv(newconn, &buf) == ERR_OK) 
-          {
-            do 
-            {
-              netbuf_data(buf, &data, &len);
-              netconn_write(newconn, data, len, NETCONN_COPY);
-          
-            } 
-            while (netbuf_next(buf) >= 0);
-          
-            netbuf_delete(buf);
-          }
-        
-          /* Close connection and discard connection identifier. */
-          netconn_close(newconn);
-          netconn_delete(newconn);
-        }
-      }
-    }
+  while (q != NULL && off >= q->len) {
+    off -= q->len;
+    q = q->next;
+  }
+  while (q != NULL) {
+    len = q->len - off;
+    if (len > tcp_sndbuf(c->pcb))
+      len = tcp_sndbuf(c->pcb);
+    if (len == 0 || tcp_write(c->pcb, (u8_t *)q->payload + off, len, TCP_WRITE_FLAG_MORE) != ERR_OK)
+      break;
+    c->sent += len;
+    tcpecho_counters.tx_segs++;
+    off += len;
+    if (off < q->len)
+      break;
+    q = q->next;
+    off = 0;
+  }
+  tcp_output(c->pcb);
+}
+
+static void tcpecho_chargen_send(struct tcpecho_conn *c)
+{
+  while (tcp_sndbuf(c->pcb) >= sizeof(chargen_lines[0])) {
+    if (tcp_write(c->pcb, chargen_lines[c->line], sizeof(chargen_lines[0]), TCP_WRITE_FLAG_MORE) != ERR_OK)
+      break;
+    tcpecho_counters.tx_segs++;
+    if (++c->line == CHARGEN_CHARS)
+      c->line = 0;
+  }
+  tcp_output(c->pcb);
+}
+
+static err_t tcpecho_sent(void *arg, struct tcp_pcb *pcb, u16_t len)
+{
+  struct tcpecho_conn *c = arg;
+  struct pbuf *next;
+
+  tcpecho_counters.tx_bytes += len;
+  if (c->service == SERVICE_CHARGEN) {
+    tcpecho_chargen_send(c);
+    return ERR_OK;
+  }
+
+  /* drop what the peer has, give the window back */
+  tcp_recved(pcb, len);
+  c->acked += len;
+  while (c->p != NULL && c->acked >= c->p->len) {
+    c->acked -= c->p->len;
+    c->sent -= c->p->len;
+    if (pbuf_get_allocsrc(c->p) != PBUF_TYPE_ALLOC_SRC_MASK_STD_HEAP)
+      c->pinned--;
     else
-    {
-      netconn_delete(newconn);
-    }
+      c->cloned -= c->p->len;
+    next = c->p->next;
+    if (next != NULL)
+      pbuf_ref(next);
+    pbuf_free(c->p);
+    c->p = next;
+  }
+
+  if (c->p != NULL)
+    tcpecho_echo_send(c);
+  else if (c->closing)
+    return tcpecho_close(c);
+  return ERR_OK;
+}
+
+static err_t tcpecho_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+  struct tcpecho_conn *c = arg;
+  struct pbuf *q;
+  u16_t segs;
+  u8_t pinned;
+
+  if (p == NULL) {
+    /* remote closed, finish the echo first */
+    if (c->p == NULL)
+      return tcpecho_close(c);
+    c->closing = 1;
+    return ERR_OK;
   }
+  if (err != ERR_OK) {
+    pbuf_free(p);
+    return err;
+  }
+
+  segs = pbuf_clen(p);
+  if (c->service != SERVICE_ECHO) {
+    tcpecho_counters.rx_bytes += p->tot_len;
+    tcpecho_counters.rx_segs += segs;
+    tcp_recved(pcb, p->tot_len);
+    pbuf_free(p);
+    return ERR_OK;
+  }
+
+  pinned = tcpecho_pinned(p);
+  if (c->pinned + pinned > TCPECHO_MAX_PINNED) {
+    /* lwIP keeps p as refused data and offers it again later; with
+     * nothing of ours in flight there is no ACK to wait for, so the
+     * first copy is always made */
+    if (c->cloned != 0 && c->cloned + p->tot_len > TCPECHO_MAX_CLONED)
+      return ERR_MEM;
+    q = pbuf_clone(PBUF_RAW, PBUF_RAM, p);
+    if (q == NULL)
+      return ERR_MEM;
+    pbuf_free(p);
+    p = q;
+    pinned = 0;
+    c->cloned += p->tot_len;
+  }
+  c->pinned += pinned;
+  tcpecho_counters.rx_bytes += p->tot_len;
+  tcpecho_counters.rx_segs += segs;
+
+  if (c->p == NULL)
+    c->p = p;
+  else
+    pbuf_cat(c->p, p);
+  tcpecho_echo_send(c);
+  return ERR_OK;
+}
+
+static err_t tcpecho_poll(void *arg, struct tcp_pcb *pcb)
+{
+  struct tcpecho_conn *c = arg;
+
+  if (c->service == SERVICE_ECHO && c->p != NULL)
+    tcpecho_echo_send(c); /* tcp_write ran out of memory earlier */
+  else if (c->service == SERVICE_CHARGEN)
+    tcpecho_chargen_send(c);
+  return ERR_OK;
+}
+
+static void tcpecho_err(void *arg, err_t err)
+{
+  /* pcb is already gone */
+  if (arg != NULL)
+    tcpecho_release(arg);
+}
+
+static err_t tcpecho_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
+{
+  u8_t service = (u8_t)(uintptr_t)arg;
+  struct tcpecho_conn *c = NULL;
+  u8_t i;
+
+  if (err != ERR_OK || newpcb == NULL)
+    return ERR_VAL;
+
+  if (service != SERVICE_ECHO || tcpecho_count(SERVICE_ECHO) < TCPECHO_MAX_ECHO) {
+    for (i = 0; i < TCPECHO_MAX_CONN && c == NULL; i++)
+      if (tcpecho_conns[i].pcb == NULL)
+        c = &tcpecho_conns[i];
+  }
+  if (c == NULL) {
+    tcpecho_counters.refused++;
+    tcp_abort(newpcb);
+    return ERR_ABRT;
+  }
+
+  c->pcb = newpcb;
+  c->service = service;
+  tcp_arg(newpcb, c);
+  tcp_recv(newpcb, tcpecho_recv);
+  tcp_sent(newpcb, tcpecho_sent);
+  tcp_err(newpcb, tcpecho_err);
+  tcp_poll(newpcb, tcpecho_poll, TCPECHO_POLL);
+  tcpecho_counters.accepted++;
+
+  if (service == SERVICE_CHARGEN)
+    tcpecho_chargen_send(c);
+  return ERR_OK;
+}
+
+static void tcpecho_listen(u16_t port, u8_t service)
+{
+  struct tcp_pcb *pcb = tcp_new_ip_type(IPADDR_TYPE_ANY);
+
+  if (pcb == NULL)
+    return;
+  if (tcp_bind(pcb, IP_ANY_TYPE, port) != ERR_OK) {
+    tcp_close(pcb);
+    return;
+  }
+  pcb = tcp_listen(pcb);
+  tcp_arg(pcb, (void *)(uintptr_t)service);
+  tcp_accept(pcb, tcpecho_accept);
+}
+
+static void tcpecho_start(void *arg)
+{
+  LWIP_UNUSED_ARG(arg);
+
+  tcpecho_listen(TCPECHO_PORT_ECHO, SERVICE_ECHO);
+  tcpecho_listen(TCPECHO_PORT_DISCARD, SERVICE_DISCARD);
+  tcpecho_listen(TCPECHO_PORT_CHARGEN, SERVICE_CHARGEN);
 }
 /*-----------------------------------------------------------------------------------*/
 
+/* Totals, and rates over the time since the previous call */
+void tcpecho_stats(tcpecho_stats_t *total, tcpecho_stats_t *per_s)
+{
+  static tcpecho_stats_t last;
+  static u32_t last_ms;
+  u32_t now;
+  u32_t ms;
+
+  /* the counters change under the core lock, and several telnet
+   * sessions may ask at once */
+  LOCK_TCPIP_CORE();
+  now = sys_now();
+  ms = now - last_ms;
+  *total = tcpecho_counters;
+  if (ms == 0)
+    ms = 1;
+  per_s->rx_bytes = (u64_t)(total->rx_bytes - last.rx_bytes) * 1000 / ms;
+  per_s->rx_segs = (u64_t)(total->rx_segs - last.rx_segs) * 1000 / ms;
+  per_s->tx_bytes = (u64_t)(total->tx_bytes - last.tx_bytes) * 1000 / ms;
+  per_s->tx_segs = (u64_t)(total->tx_segs - last.tx_segs) * 1000 / ms;
+  per_s->accepted = total->accepted - last.accepted;
+  per_s->refused = total->refused - last.refused;
+  last = *total;
+  last_ms = now;
+  UNLOCK_TCPIP_CORE();
+}
+
 void tcpecho_init(void)
 {
-  sys_thread_new("tcpecho_thread", tcpecho_thread, NULL, DEFAULT_THREAD_STACKSIZE, TCPECHO_THREAD_PRIO);
+  u8_t i, j;
+
+  for (i = 0; i < CHARGEN_CHARS; i++) {
+    for (j = 0; j < CHARGEN_LINE; j++)
+      chargen_lines[i][j] = ' ' + (i + j) % CHARGEN_CHARS;
+    chargen_lines[i][CHARGEN_LINE] = '\r';
+    chargen_lines[i][CHARGEN_LINE + 1] = '\n';
+  }
+  tcpip_callback(tcpecho_start, NULL);
 }
 /*-----------------------------------------------------------------------------------*/
 
-#endif /* LWIP_NETCONN */
+#endif /* LWIP_TCP */
@@ -38,145 +38,230 @@
 
 #include "lwip/sys.h"
 #include "lwip/api.h"
+#include "cmd.h"
+#include "tcpecho.h"
+#include "ethernetif_stats.h"
 
 #define TELNET_THREAD_PRIO  ( tskIDLE_PRIORITY + 4 )
-#define CMD_BUFFER_LEN 		1024
+#define CMD_BUFFER_LEN 		256
 
-static void http_client(char *s, uint16_t size)
+/* Sessions are served by a fixed pool of worker threads, each with its
+ * own slot and line buffer. Clients over the limit are turned away. */
+#ifndef TELNET_MAX_SESSIONS
+#define TELNET_MAX_SESSIONS 4
+#endif
+#define TELNET_LISTEN_STACK 256
+#define TELNET_SESSION_STACK 512
+#define TELNET_OUT_LEN 512 // a whole reply normally fits, one segment per command;
+/* A session without input for this long is closed and its slot freed */
+#ifndef TELNET_IDLE_TIMEOUT
+#define TELNET_IDLE_TIMEOUT 300000 // ms;
+#endif
+
+typedef struct {
+	struct netconn *volatile conn; // NULL while the slot is free;
+	sys_sem_t start;
+	uint16_t cnt;
+	char data[CMD_BUFFER_LEN];
+	uint16_t out_len;
+	char out_last;
+	char out[TELNET_OUT_LEN];
+} telnet_session_t;
+
+static telnet_session_t telnet_sessions[TELNET_MAX_SESSIONS];
+static uint8_t telnet_workers; // sessions that got their thread;
+
+static void http_client(cmd_sink_t *out)
 {
 	struct netconn *client;
 	struct netbuf *buf;
 	ip_addr_t ip;
-	uint16_t len = 0;
+	void *data;
+	u16_t len;
 	IP_ADDR4(&ip, 147, 229, 144, 124);
 	const char *request = "GET /ip.php HTTP/1.1\r\n"
 			"Host: www.urel.feec.vutbr.cz\r\n"
 			"Connection: close\r\n"
 			"\r\n\r\n";
 	client = netconn_new(NETCONN_TCP);
-	if (netconn_connect(client, &ip, 80) == ERR_OK) {
+	if (client != NULL && netconn_connect(client, &ip, 80) == ERR_OK) {
 		netconn_write(client, request, strlen(request), NETCONN_COPY);
-		// Receive the HTTP response
-		s[0] = 0;
-		while (len < size && netconn_recv(client, &buf) == ERR_OK) {
-			len += netbuf_copy(buf, &s[len], size - len);
-			s[len] = 0;
+		// Pass the HTTP response on as it comes, no copy of the whole page;
+		while (netconn_recv(client, &buf) == ERR_OK) {
+			do {
+				netbuf_data(buf, &data, &len);
+				out->write(out->ctx, data, len);
+			} while (netbuf_next(buf) >= 0);
 			netbuf_delete(buf);
 		}
 	} else {
-		sprintf(s, "Chyba pripojeni\n");
+		cmd_puts(out, "Chyba pripojeni\n");
 	}
-	netconn_delete(client);
+	if (client != NULL)
+		netconn_delete(client);
+}
+
+/* more keeps lwIP from pushing a partial reply out as its own segment */
+static void telnet_flush(telnet_session_t *s, uint8_t more)
+{
+	if (s->out_len)
+		netconn_write(s->conn, s->out, s->out_len, NETCONN_COPY | (more ? NETCONN_MORE : 0));
+	s->out_len = 0;
 }
 
-static void telnet_process_command(char *cmd, struct netconn *conn)
+static void telnet_put(telnet_session_t *s, char c)
 {
-	char s[1024];
-	char *token;
+	if (s->out_len == TELNET_OUT_LEN)
+		telnet_flush(s, 1);
+	s->out[s->out_len++] = c;
+	s->out_last = c;
+}
 
-	if (strlen(cmd) == 0){
-		return;
+/* Output sink for the command table, collects the reply in the session
+ * buffer, bare \n becomes \r\n on the wire */
+static void telnet_sink_write(void *ctx, const char *str, uint16_t len)
+{
+	telnet_session_t *s = ctx;
+	uint16_t i;
+
+	for (i = 0; i < len; i++) {
+		if (str[i] == '\n' && s->out_last != '\r')
+			telnet_put(s, '\r');
+		telnet_put(s, str[i]);
 	}
+}
 
+static void telnet_led(cmd_args_t *args, cmd_sink_t *out, GPIO_TypeDef *port, uint16_t pin)
+{
+	uint8_t on;
 
-	token = strtok(cmd, " ");
+	if (cmd_next_onoff(args, &on))
+		HAL_GPIO_WritePin(port, pin, on ? GPIO_PIN_SET : GPIO_PIN_RESET);
+	cmd_puts(out, "OK\n");
+}
 
-	if (strcasecmp(token, "HELLO") == 0)
-	{
-		sprintf(s, "Komunikace OK\r\n");
-	}
-	else if (strcasecmp(token, "LED1") == 0)
-	{
-		token = strtok(NULL, " ");
-		if (strcasecmp(token, "ON") == 0)
-		{
-			HAL_GPIO_WritePin(LD1_GPIO_Port, LD1_Pin, GPIO_PIN_SET);
-		}
-		else if (strcasecmp(token, "OFF") == 0)
-		{
-			HAL_GPIO_WritePin(LD1_GPIO_Port, LD1_Pin, GPIO_PIN_RESET);
-		}
-		sprintf(s, "OK\r\n");
-	}
-	else if (strcasecmp(token, "LED2") == 0)
-	{
-		token = strtok(NULL, " ");
-		if (strcasecmp(token, "ON") == 0)
-		{
-			HAL_GPIO_WritePin(LD2_GPIO_Port, LD2_Pin, GPIO_PIN_SET);
-		}
-		else if (strcasecmp(token, "OFF") == 0)
-		{
-			HAL_GPIO_WritePin(LD2_GPIO_Port, LD2_Pin, GPIO_PIN_RESET);
-		}
-		sprintf(s, "OK\r\n");
-	}
-	else if (strcasecmp(token, "LED3") == 0)
-	{
-		token = strtok(NULL, " ");
-		if (strcasecmp(token, "ON") == 0)
-		{
-			HAL_GPIO_WritePin(LD3_GPIO_Port, LD3_Pin, GPIO_PIN_SET);
-		}
-		else if (strcasecmp(token, "OFF") == 0)
-		{
-			HAL_GPIO_WritePin(LD3_GPIO_Port, LD3_Pin, GPIO_PIN_RESET);
-		}
-		sprintf(s, "OK\r\n");
-	}
-	else if (strcasecmp(token, "STATUS") == 0)
-	{
-		sprintf(s, "STATE: \r\n");
-		netconn_write(conn, s, strlen(s), NETCONN_COPY);
-		if (HAL_GPIO_ReadPin(LD1_GPIO_Port, LD1_Pin) == 0){
-			sprintf(s, "LED1=OFF\r\n");
-			netconn_write(conn, s, strlen(s), NETCONN_COPY);
-		}
-		else{
-			sprintf(s, "LED1=ON\r\n");
-			netconn_write(conn, s, strlen(s), NETCONN_COPY);
-		}
+static void cmd_hello(cmd_args_t *args, cmd_sink_t *out)
+{
+	cmd_puts(out, "Komunikace OK\n");
+}
 
-		if (HAL_GPIO_ReadPin(LD2_GPIO_Port, LD2_Pin) == 0){
-			sprintf(s, "LED2=OFF\r\n");
-			netconn_write(conn, s, strlen(s), NETCONN_COPY);
-		}
-		else {
-			sprintf(s, "LED2=ON\r\n");
-			netconn_write(conn, s, strlen(s), NETCONN_COPY);
-		}
+static void cmd_led1(cmd_args_t *args, cmd_sink_t *out)
+{
+	telnet_led(args, out, LD1_GPIO_Port, LD1_Pin);
+}
 
-		if (HAL_GPIO_ReadPin(LD3_GPIO_Port, LD3_Pin) == 0){
-			sprintf(s, "LED3=OFF\r\n");
-		}
-		else {
-			sprintf(s, "LED3=ON\r\n");
-		}
-	}
-	else if (strcasecmp(token, "CLIENT") == 0){
+static void cmd_led2(cmd_args_t *args, cmd_sink_t *out)
+{
+	telnet_led(args, out, LD2_GPIO_Port, LD2_Pin);
+}
 
-		http_client(s, 1024);
+static void cmd_led3(cmd_args_t *args, cmd_sink_t *out)
+{
+	telnet_led(args, out, LD3_GPIO_Port, LD3_Pin);
+}
 
-	}
-	netconn_write(conn, s, strlen(s), NETCONN_COPY);
+static void cmd_status(cmd_args_t *args, cmd_sink_t *out)
+{
+	cmd_puts(out, "STATE: \n");
+	cmd_puts(out, HAL_GPIO_ReadPin(LD1_GPIO_Port, LD1_Pin) ? "LED1=ON\n" : "LED1=OFF\n");
+	cmd_puts(out, HAL_GPIO_ReadPin(LD2_GPIO_Port, LD2_Pin) ? "LED2=ON\n" : "LED2=OFF\n");
+	cmd_puts(out, HAL_GPIO_ReadPin(LD3_GPIO_Port, LD3_Pin) ? "LED3=ON\n" : "LED3=OFF\n");
+}
+
+static void cmd_client(cmd_args_t *args, cmd_sink_t *out)
+{
+	http_client(out);
+}
+
+/* Echo service counters, rates are over the time since the last ECHO */
+static void cmd_echo(cmd_args_t *args, cmd_sink_t *out)
+{
+	tcpecho_stats_t total, rate;
+
+	tcpecho_stats(&total, &rate);
+	cmd_printf(out, "RX %lu B %lu seg, %lu B/s %lu seg/s\n", total.rx_bytes, total.rx_segs, rate.rx_bytes, rate.rx_segs);
+	cmd_printf(out, "TX %lu B %lu seg, %lu B/s %lu seg/s\n", total.tx_bytes, total.tx_segs, rate.tx_bytes, rate.tx_segs);
+	cmd_printf(out, "CONN %lu accepted, %lu refused\n", total.accepted, total.refused);
+}
+
+/* Ethernet Rx buffer counters since boot */
+static void cmd_rx(cmd_args_t *args, cmd_sink_t *out)
+{
+	ethernetif_rx_stats_t st;
+
+	ethernetif_rx_stats(&st);
+	cmd_printf(out, "FRAMES %lu, %lu copied, max batch %lu\n", st.frames, st.copied, st.max_batch);
+	cmd_printf(out, "POOL %u in use, %u peak, %lu exhausted\n", st.in_use, st.hwm, st.exhausted);
+	cmd_printf(out, "DROP %lu rbus, %lu no desc, %lu overflow\n", st.rbus, st.nodesc, st.overflow);
 }
 
-static void telnet_byte_available(uint8_t c, struct netconn *conn)
+static const cmd_entry_t telnet_commands[] = { /* keep sorted by name */
+	{ "CLIENT", cmd_client },
+	{ "ECHO", cmd_echo },
+	{ "HELLO", cmd_hello },
+	{ "LED1", cmd_led1 },
+	{ "LED2", cmd_led2 },
+	{ "LED3", cmd_led3 },
+	{ "RX", cmd_rx },
+	{ "STATUS", cmd_status },
+};
+
+static void telnet_process_command(telnet_session_t *s)
 {
-	static uint16_t cnt;
-	static char data[CMD_BUFFER_LEN];
+	cmd_sink_t out = { telnet_sink_write, s };
 
+	s->out_len = 0;
+	s->out_last = 0;
+	cmd_execute(telnet_commands, CMD_COUNT(telnet_commands), s->data, &out);
+	telnet_flush(s, 0);
+}
 
-	if (cnt < CMD_BUFFER_LEN && c >= 32 && c <= 127)
-		data[cnt++] = c;
+static void telnet_byte_available(telnet_session_t *s, uint8_t c)
+{
+	if (s->cnt < CMD_BUFFER_LEN - 1 && c >= 32 && c <= 127)
+		s->data[s->cnt++] = c;
 	if (c == '\n' || c == '\r')
 	{
-		data[cnt] = '\0';
-		telnet_process_command(data, conn);
-		cnt = 0;
+		s->data[s->cnt] = '\0';
+		telnet_process_command(s);
+		s->cnt = 0;
 	}
+}
 
+static void telnet_session_thread(void *arg)
+{
+  telnet_session_t *s = arg;
+  struct netbuf *buf;
+  uint8_t *data;
+  u16_t len;
+
+  while (1)
+  {
+    /* Wait for the listener to hand over a connection. */
+    sys_arch_sem_wait(&s->start, 0);
+    s->cnt = 0;
+    /* netconn_recv() fails with ERR_TIMEOUT once the client goes quiet,
+     * which ends the loop below like a disconnect */
+    netconn_set_recvtimeout(s->conn, TELNET_IDLE_TIMEOUT);
+
+    while (netconn_recv(s->conn, &buf) == ERR_OK)
+    {
+      do
+      {
+        netbuf_data(buf, (void**)&data, &len);
+        while (len--)
+          telnet_byte_available(s, *data++);
+      }
+      while (netbuf_next(buf) >= 0);
+
+      netbuf_delete(buf);
+    }
 
+    /* Close connection and give the slot back. */
+    netconn_close(s->conn);
+    netconn_delete(s->conn);
+    s->conn = NULL;
+  }
 }
 
 /*-----------------------------------------------------------------------------------*/
@@ -184,10 +269,8 @@ static void telnet_thread(void *arg)
 {
   struct netconn *conn, *newconn;
   err_t err, accept_err;
-  struct netbuf *buf;
-  uint8_t *data;
-  u16_t len;
-      
+  uint8_t i;
+
   LWIP_UNUSED_ARG(arg);
 
   /* Create a new connection identifier. */
@@ -208,33 +291,28 @@ static void telnet_thread(void *arg)
         /* Grab new connection. */
          accept_err = netconn_accept(conn, &newconn);
     
-        /* Process the new connection. */
+        /* Hand the new connection to a free session. */
         if (accept_err == ERR_OK) 
         {
+          for (i = 0; i < telnet_workers && telnet_sessions[i].conn != NULL; i++);
 
-          while (netconn_recv(newconn, &buf) == ERR_OK) 
+          if (i < telnet_workers)
           {
-            do 
-            {
-              netbuf_data(buf, (void**)&data, &len);
-              while (len--)
-            	  telnet_byte_available(*data++, newconn);
-          
-            } 
-            while (netbuf_next(buf) >= 0);
-          
-            netbuf_delete(buf);
+            telnet_sessions[i].conn = newconn;
+            sys_sem_signal(&telnet_sessions[i].start);
+          }
+          else
+          {
+            netconn_write(newconn, "Too many sessions\r\n", 19, NETCONN_NOCOPY);
+            netconn_close(newconn);
+            netconn_delete(newconn);
           }
-        
-          /* Close connection and discard connection identifier. */
-          netconn_close(newconn);
-          netconn_delete(newconn);
         }
       }
     }
     else
     {
-      netconn_delete(newconn);
+      netconn_delete(conn);
     }
   }
 }
@@ -242,7 +320,16 @@ static void telnet_thread(void *arg)
 
 void telnet_init(void)
 {
-  sys_thread_new("telnet_thread", telnet_thread, NULL, DEFAULT_THREAD_STACKSIZE, TELNET_THREAD_PRIO);
+  for (telnet_workers = 0; telnet_workers < TELNET_MAX_SESSIONS; telnet_workers++)
+  {
+    telnet_session_t *s = &telnet_sessions[telnet_workers];
+
+    if (sys_sem_new(&s->start, 0) != ERR_OK)
+      break;
+    if (sys_thread_new("telnet_session", telnet_session_thread, s, TELNET_SESSION_STACK, TELNET_THREAD_PRIO) == NULL)
+      break;
+  }
+  sys_thread_new("telnet_thread", telnet_thread, NULL, TELNET_LISTEN_STACK, TELNET_THREAD_PRIO);
 }
 /*-----------------------------------------------------------------------------------*/
 
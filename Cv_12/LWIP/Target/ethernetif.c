@@ -40,8 +40,10 @@
 /* The time to block waiting for input. */
 #define TIME_WAITING_FOR_INPUT ( portMAX_DELAY )
 /* USER CODE BEGIN OS_THREAD_STACK_SIZE_WITH_RTOS */
-/* Stack size of the interface thread */
-#define INTERFACE_THREAD_STACK_SIZE ( 350 )
+/* Stack size of the interface thread. ethernetif_input() runs
+ * ethernet_input() and everything above it (ARP, IP, TCP, raw API
+ * callbacks) under the core lock, so it needs the tcpip thread's stack. */
+#define INTERFACE_THREAD_STACK_SIZE ( TCPIP_THREAD_STACKSIZE )
 /* USER CODE END OS_THREAD_STACK_SIZE_WITH_RTOS */
 /* Network interface name */
 #define IFNAME0 's'
@@ -103,7 +105,19 @@ ETH_DMADescTypeDef  DMARxDscrTab[ETH_RX_DESC_CNT]; /* Ethernet Rx DMA Descriptor
 ETH_DMADescTypeDef  DMATxDscrTab[ETH_TX_DESC_CNT]; /* Ethernet Tx DMA Descriptors */
 
 /* USER CODE BEGIN 2 */
-
+/* Finished Tx frames are reclaimed in tcpip_thread, the Tx complete
+ * interrupt only posts this message (at most one in flight) */
+static struct tcpip_callback_msg *TxReclaimMsg = NULL;
+static volatile uint8_t TxReclaimPending = 0;
+
+/* Once fewer than ETH_RX_DESC_CNT RX_POOL buffers are free, frames are
+ * copied to PBUF_POOL and their buffer goes straight back to the ring,
+ * so pbufs held by the stack can't starve the DMA of descriptors */
+#define ETH_RX_COPY_THRESHOLD         (ETH_RX_BUFFER_CNT - ETH_RX_DESC_CNT)
+/* Frames handed to the stack per core lock hold */
+#define ETH_RX_BATCH_MAX              ETH_RX_BUFFER_CNT
+
+static ethernetif_rx_stats_t RxStats;
 /* USER CODE END 2 */
 
 osSemaphoreId RxPktSemaphore = NULL;   /* Semaphore to signal incoming packets */
@@ -128,7 +142,7 @@ lan8742_IOCtx_t  LAN8742_IOCtx = {ETH_PHY_IO_Init,
                                   ETH_PHY_IO_GetTick};
 
 /* USER CODE BEGIN 3 */
-
+static void ethernetif_tx_reclaim(void *arg);
 /* USER CODE END 3 */
 
 /* Private functions ---------------------------------------------------------*/
@@ -151,6 +165,16 @@ void HAL_ETH_RxCpltCallback(ETH_HandleTypeDef *handlerEth)
 void HAL_ETH_TxCpltCallback(ETH_HandleTypeDef *handlerEth)
 {
   osSemaphoreRelease(TxPktSemaphore);
+
+  if((TxReclaimMsg != NULL) && (TxReclaimPending == 0U))
+  {
+    TxReclaimPending = 1U;
+    if(tcpip_callbackmsg_trycallback_fromisr(TxReclaimMsg) != ERR_OK)
+    {
+      /* mbox full, the next low_level_output() reclaims instead */
+      TxReclaimPending = 0U;
+    }
+  }
 }
 /**
   * @brief  Ethernet DMA transfer error callback
@@ -161,12 +185,25 @@ void HAL_ETH_ErrorCallback(ETH_HandleTypeDef *handlerEth)
 {
   if((HAL_ETH_GetDMAError(handlerEth) & ETH_DMASR_RBUS) == ETH_DMASR_RBUS)
   {
+     RxStats.rbus++;
      osSemaphoreRelease(RxPktSemaphore);
   }
 }
 
 /* USER CODE BEGIN 4 */
+/**
+  * @brief  Give finished Tx descriptors back and free their pbufs
+  *         (HAL_ETH_TxFreeCallback), runs in tcpip_thread
+  * @param  arg: unused
+  * @retval None
+  */
+static void ethernetif_tx_reclaim(void *arg)
+{
+  LWIP_UNUSED_ARG(arg);
 
+  TxReclaimPending = 0U;
+  HAL_ETH_ReleaseTxPacket(&heth);
+}
 /* USER CODE END 4 */
 
 /*******************************************************************************
@@ -247,6 +284,9 @@ static void low_level_init(struct netif *netif)
   /* create a binary semaphore used for informing ethernetif of frame transmission */
   TxPktSemaphore = xSemaphoreCreateBinary();
 
+  /* Tx complete interrupt defers descriptor reclaim to tcpip_thread */
+  TxReclaimMsg = tcpip_callbackmsg_new(ethernetif_tx_reclaim, NULL);
+
   /* create the task that handles the ETH_MAC */
 /* USER CODE BEGIN OS_THREAD_DEF_CREATE_CMSIS_RTOS_V1 */
   osThreadDef(EthIf, ethernetif_input, osPriorityRealtime, 0, INTERFACE_THREAD_STACK_SIZE);
@@ -350,10 +390,40 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p)
 
   memset(Txbuffer, 0 , ETH_TX_DESC_CNT*sizeof(ETH_BufferTypeDef));
 
+  /* The frame stays queued after this returns, so it may only point at
+   * data its pbufs keep alive. PBUF_ROM/PBUF_REF parts (tcp_write()
+   * without copy, like the zero-copy echo into RX_POOL buffers) don't:
+   * their owner may reuse the memory once the peer ACKs, possibly before
+   * the DMA gets to it. Such frames go out as one PBUF_RAM copy. From
+   * here on p is a reference this function owns. */
+  for(q = p; q != NULL; q = q->next)
+  {
+    if(!(q->type_internal & PBUF_TYPE_FLAG_STRUCT_DATA_CONTIGUOUS) &&
+       !(q->flags & PBUF_FLAG_IS_CUSTOM))
+    {
+      break;
+    }
+  }
+  if(q != NULL)
+  {
+    p = pbuf_clone(PBUF_RAW, PBUF_RAM, p);
+    if(p == NULL)
+    {
+      return ERR_MEM;
+    }
+  }
+  else
+  {
+    pbuf_ref(p);
+  }
+
   for(q = p; q != NULL; q = q->next)
   {
     if(i >= ETH_TX_DESC_CNT)
+    {
+      pbuf_free(p);
       return ERR_IF;
+    }
 
     Txbuffer[i].buffer = q->payload;
     Txbuffer[i].len = q->len;
@@ -375,15 +445,28 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p)
   TxConfig.TxBuffer = Txbuffer;
   TxConfig.pData = p;
 
-  pbuf_ref(p);
-
-  HAL_ETH_Transmit_IT(&heth, &TxConfig);
-  while(osSemaphoreWait(TxPktSemaphore, TIME_WAITING_FOR_INPUT)!=osOK)
-
+  /* Don't wait for the frame itself, only for enough free descriptors.
+   * Up to ETH_TX_DESC_CNT frames stay queued, each holding a reference to
+   * its pbuf until HAL_ETH_ReleaseTxPacket() finds it sent and
+   * HAL_ETH_TxFreeCallback() drops the reference. Checking the room up
+   * front also keeps HAL from half-arming a chain and backing it out. */
+  HAL_ETH_ReleaseTxPacket(&heth);
+  while((heth.TxDescList.BuffersInUse + i) > ETH_TX_DESC_CNT)
   {
+    if(osSemaphoreWait(TxPktSemaphore, ETH_DMA_TRANSMIT_TIMEOUT) != osOK)
+    {
+      /* DMA stuck (link down), drop the frame */
+      pbuf_free(p);
+      return ERR_IF;
+    }
+    HAL_ETH_ReleaseTxPacket(&heth);
   }
 
-  HAL_ETH_ReleaseTxPacket(&heth);
+  if(HAL_ETH_Transmit_IT(&heth, &TxConfig) != HAL_OK)
+  {
+    pbuf_free(p);
+    errval = ERR_IF;
+  }
 
   return errval;
 }
@@ -399,10 +482,22 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p)
 static struct pbuf * low_level_input(struct netif *netif)
 {
   struct pbuf *p = NULL;
+  struct pbuf *q = NULL;
 
-  if(RxAllocStatus == RX_ALLOC_OK)
+  /* Read even while RX_POOL is dry: frames already in the ring carry
+   * their own buffers, and HAL retries the re-arm on every call */
+  HAL_ETH_ReadData(&heth, (void **)&p);
+
+  if((p != NULL) && (RxStats.in_use > ETH_RX_COPY_THRESHOLD))
   {
-    HAL_ETH_ReadData(&heth, (void **)&p);
+    q = pbuf_alloc(PBUF_RAW, p->tot_len, PBUF_POOL);
+    if(q != NULL)
+    {
+      pbuf_copy(q, p);
+      pbuf_free(p);
+      p = q;
+      RxStats.copied++;
+    }
   }
 
   return p;
@@ -421,22 +516,42 @@ static void ethernetif_input(void const * argument)
 {
   struct pbuf *p = NULL;
   struct netif *netif = (struct netif *) argument;
+  uint32_t batch;
+  uint32_t frames;
 
   for( ;; )
   {
     if (osSemaphoreWait(RxPktSemaphore, TIME_WAITING_FOR_INPUT) == osOK)
     {
+      /* Drain every ready frame before waiting again. The frames go to
+       * ethernet_input() under the core lock, one lock per batch, instead
+       * of one tcpip_input() message each through the small tcpip mbox. */
+      frames = 0;
       do
       {
-        p = low_level_input( netif );
-        if (p != NULL)
+        batch = 0;
+        LOCK_TCPIP_CORE();
+        do
         {
-          if (netif->input( p, netif) != ERR_OK )
+          p = low_level_input( netif );
+          if (p != NULL)
           {
-            pbuf_free(p);
+            if (ethernet_input(p, netif) != ERR_OK)
+            {
+              pbuf_free(p);
+            }
+            batch++;
           }
-        }
-      } while(p!=NULL);
+        } while((p != NULL) && (batch < ETH_RX_BATCH_MAX));
+        UNLOCK_TCPIP_CORE();
+        frames += batch;
+      } while(p != NULL);
+
+      RxStats.frames += frames;
+      if (frames > RxStats.max_batch)
+      {
+        RxStats.max_batch = frames;
+      }
     }
   }
 }
@@ -527,9 +642,14 @@ err_t ethernetif_init(struct netif *netif)
   */
 void pbuf_free_custom(struct pbuf *p)
 {
+  SYS_ARCH_DECL_PROTECT(old_level);
   struct pbuf_custom* custom_pbuf = (struct pbuf_custom*)p;
   LWIP_MEMPOOL_FREE(RX_POOL, custom_pbuf);
 
+  SYS_ARCH_PROTECT(old_level);
+  RxStats.in_use--;
+  SYS_ARCH_UNPROTECT(old_level);
+
   /* If the Rx Buffer Pool was exhausted, signal the ethernetif_input task to
    * call HAL_ETH_GetRxDataBuffer to rebuild the Rx descriptors. */
 
@@ -541,6 +661,23 @@ void pbuf_free_custom(struct pbuf *p)
 }
 
 /* USER CODE BEGIN 6 */
+/**
+  * @brief  Snapshot of the Rx buffer counters
+  * @param  st: filled with the counters since boot
+  * @retval None
+  */
+void ethernetif_rx_stats(ethernetif_rx_stats_t *st)
+{
+  SYS_ARCH_DECL_PROTECT(old_level);
+  /* The MAC counters clear on read, so accumulate them here */
+  uint32_t mfbocr = heth.Instance->DMAMFBOCR;
+
+  SYS_ARCH_PROTECT(old_level);
+  RxStats.nodesc += (mfbocr & ETH_DMAMFBOCR_MFC) >> ETH_DMAMFBOCR_MFC_Pos;
+  RxStats.overflow += (mfbocr & ETH_DMAMFBOCR_MFA) >> ETH_DMAMFBOCR_MFA_Pos;
+  *st = RxStats;
+  SYS_ARCH_UNPROTECT(old_level);
+}
 
 /**
 * @brief  Returns the current time in milliseconds
@@ -813,9 +950,17 @@ void ethernet_link_thread(void const * argument)
 void HAL_ETH_RxAllocateCallback(uint8_t **buff)
 {
 /* USER CODE BEGIN HAL ETH RxAllocateCallback */
+  SYS_ARCH_DECL_PROTECT(old_level);
   struct pbuf_custom *p = LWIP_MEMPOOL_ALLOC(RX_POOL);
   if (p)
   {
+    SYS_ARCH_PROTECT(old_level);
+    if (++RxStats.in_use > RxStats.hwm)
+    {
+      RxStats.hwm = RxStats.in_use;
+    }
+    SYS_ARCH_UNPROTECT(old_level);
+
     /* Get the buff from the struct pbuf address. */
     *buff = (uint8_t *)p + offsetof(RxBuff_t, buff);
     p->custom_free_function = pbuf_free_custom;
@@ -826,6 +971,10 @@ void HAL_ETH_RxAllocateCallback(uint8_t **buff)
   }
   else
   {
+    if (RxAllocStatus == RX_ALLOC_OK)
+    {
+      RxStats.exhausted++;
+    }
     RxAllocStatus = RX_ALLOC_ERROR;
     *buff = NULL;
   }
@@ -41,6 +41,6 @@ u32_t sys_jiffies(void);
 u32_t sys_now(void);
 
 /* USER CODE BEGIN 1 */
-
+#include "ethernetif_stats.h"
 /* USER CODE END 1 */
 #endif
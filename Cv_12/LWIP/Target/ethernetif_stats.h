@@ -0,0 +1,29 @@
+/*
+ * ethernetif_stats.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: xalech00
+ */
+
+#ifndef ETHERNETIF_STATS_H_
+#define ETHERNETIF_STATS_H_
+
+#include <stdint.h>
+
+/* Rx path counters, see ethernetif_rx_stats() */
+typedef struct
+{
+  uint32_t frames;      /* frames handed to the stack */
+  uint32_t copied;      /* of those, copied out while RX_POOL ran low */
+  uint32_t max_batch;   /* most frames drained in one wakeup */
+  uint32_t exhausted;   /* times RX_POOL ran dry re-arming the ring */
+  uint32_t rbus;        /* DMA found no armed descriptor */
+  uint32_t nodesc;      /* frames the MAC dropped for lack of descriptor */
+  uint32_t overflow;    /* frames the MAC dropped on Rx FIFO overflow */
+  uint16_t in_use;      /* RX_POOL buffers in the ring or in the stack */
+  uint16_t hwm;         /* most RX_POOL buffers out at once */
+} ethernetif_rx_stats_t;
+
+void ethernetif_rx_stats(ethernetif_rx_stats_t *st);
+
+#endif /* ETHERNETIF_STATS_H_ */
@@ -0,0 +1,89 @@
+/*
+ * calib_test.c
+ *
+ * Cv_04 calib.c with the factory constants mocked: the system memory page
+ * holding them is mapped at its target address, so calib.c reads its
+ * TEMP30/TEMP110/VREFINT addresses unchanged. Results are compared with
+ * the datasheet formulas in double precision.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <sys/mman.h>
+#include "calib.h"
+#include "test.h"
+
+#define SYSMEM_PAGE 0x1FFFF000UL
+#define TEMP30_CAL (*(uint16_t *) 0x1FFFF7B8UL)
+#define TEMP110_CAL (*(uint16_t *) 0x1FFFF7C2UL)
+#define VREFINT_CAL (*(uint16_t *) 0x1FFFF7BAUL)
+
+/* Rounding to the unit plus the Q16 reciprocal error over 4095 LSB */
+#define VOLT_TOL (0.5 + 4095 * 0.5 / 65536)
+
+static void check_range(double vdda) {
+
+	for (uint32_t raw = 0; raw <= 4095; raw++) {
+		double mv = raw * vdda / 4095;
+		double e = fabs(adc_to_millivolts(raw) - mv);
+		CHECK(e <= VOLT_TOL);
+		e = fabs(adc_to_centivolts(raw) - mv / 10);
+		CHECK(e <= VOLT_TOL);
+
+		double raw_cal = raw * vdda / 3300;
+		double t = 30 + (raw_cal - TEMP30_CAL) * 80 / (TEMP110_CAL - TEMP30_CAL);
+		if (t < -40 || t > 125) continue;
+		CHECK(fabs(adc_to_centidegrees(raw) - t * 100) <= 2);
+		CHECK(fabs(adc_to_decidegrees(raw) - t * 10) <= 0.6);
+	}
+}
+
+int main(void) {
+	void *page = mmap((void *) SYSMEM_PAGE, 0x1000, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+	if (page != (void *) SYSMEM_PAGE) {
+		printf("%s: cannot map the calibration page\n", __FILE__);
+		return 1;
+	}
+
+	/* Two parts' worth of constants; the sensor slope is negative on F0 */
+	static const uint16_t parts[][3] = {
+		{ 1750, 1310, 1525 },
+		{ 1778, 1343, 1497 },
+	};
+	for (uint32_t p = 0; p < 2; p++) {
+		TEMP30_CAL = parts[p][0];
+		TEMP110_CAL = parts[p][1];
+		VREFINT_CAL = parts[p][2];
+		calib_init();
+
+		/* Before any VREFINT sample VDDA is the calibration 3.3 V */
+		CHECK_EQ(calib_vdda_mv(), 3300);
+		CHECK_EQ(calib_vdda_cv(), 330);
+		CHECK_EQ(adc_to_millivolts(4095), 3300);
+		CHECK_EQ(adc_to_centivolts(4095), 330);
+		CHECK_EQ(adc_to_centidegrees(TEMP30_CAL), 3000);
+		CHECK_EQ(adc_to_decidegrees(TEMP30_CAL), 300);
+		CHECK(abs(adc_to_decidegrees(TEMP110_CAL) - 1100) <= 1);
+		check_range(3300);
+
+		/* VREFINT reading at the calibration point changes nothing */
+		calib_set_vref(VREFINT_CAL);
+		CHECK_EQ(calib_vdda_mv(), 3300);
+
+		for (uint32_t vdda = 2400; vdda <= 3600; vdda += 150) {
+			uint16_t raw_vref = (VREFINT_CAL * 3300 + vdda / 2) / vdda;
+			calib_set_vref(raw_vref);
+			double exact = 3300.0 * VREFINT_CAL / raw_vref;
+			CHECK(fabs(calib_vdda_mv() - exact) <= 1);
+			CHECK(fabs(calib_vdda_cv() - exact / 10) <= 0.5 + 1e-9);
+			check_range(calib_vdda_mv());
+		}
+
+		/* A zero VREFINT sample (ADC not running yet) is ignored */
+		uint16_t before = calib_vdda_mv();
+		calib_set_vref(0);
+		CHECK_EQ(calib_vdda_mv(), before);
+	}
+	TEST_END();
+}
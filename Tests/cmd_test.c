@@ -0,0 +1,95 @@
+/*
+ * cmd_test.c
+ *
+ * The console parser shared by Cv_05 and Cv_12 (cmd.c, built once from
+ * each project): table lookup, number and hex arguments, printf sink.
+ */
+#include <stdint.h>
+#include <string.h>
+#include "cmd.h"
+#include "test.h"
+
+static char out_buf[512];
+static uint16_t out_len;
+
+static void sink_write(void *ctx, const char *s, uint16_t len) {
+	memcpy(&out_buf[out_len], s, len);
+	out_len += len;
+	out_buf[out_len] = '\0';
+}
+
+static cmd_sink_t sink = { sink_write, NULL };
+
+static uint8_t uint_ok(const char *line, uint32_t *v) {
+	cmd_args_t args = { line };
+	return cmd_next_uint(&args, v);
+}
+
+static uint16_t hex(const char *line, uint8_t *buf, uint16_t max) {
+	cmd_args_t args = { line };
+	return cmd_next_hex(&args, buf, max);
+}
+
+static void cmd_echo(cmd_args_t *args, cmd_sink_t *out) {
+	uint32_t v;
+	while (cmd_next_uint(args, &v))
+		cmd_printf(out, "%u;", v);
+}
+
+static void cmd_led(cmd_args_t *args, cmd_sink_t *out) {
+	uint8_t on;
+	cmd_puts(out, cmd_next_onoff(args, &on) ? (on ? "on" : "off") : "?");
+}
+
+static const cmd_entry_t table[] = {
+	{ "ECHO", cmd_echo },
+	{ "LED1", cmd_led },
+	{ "LED10", cmd_led },
+};
+
+int main(void) {
+	uint32_t v;
+	uint8_t buf[8];
+
+	CHECK(uint_ok("0", &v) && v == 0);
+	CHECK(uint_ok("  42 rest", &v) && v == 42);
+	CHECK(uint_ok("0x1F", &v) && v == 0x1F);
+	CHECK(uint_ok("0xffffffff", &v) && v == UINT32_MAX);
+	CHECK(uint_ok("4294967295", &v) && v == UINT32_MAX);
+	/* Overflow is an error, not a wrapped value */
+	CHECK(!uint_ok("4294967296", &v));
+	CHECK(!uint_ok("42949672950", &v));
+	CHECK(!uint_ok("99999999999999999999", &v));
+	CHECK(!uint_ok("0x100000000", &v));
+	CHECK(!uint_ok("0x1FFFFFFFF", &v));
+	CHECK(!uint_ok("12a", &v));
+	CHECK(!uint_ok("0xG", &v));
+	CHECK(!uint_ok("", &v));
+
+	CHECK_EQ(hex("01 aBcD", buf, sizeof(buf)), 3);
+	CHECK(buf[0] == 0x01 && buf[1] == 0xAB && buf[2] == 0xCD);
+	CHECK_EQ(hex("123", buf, sizeof(buf)), 0);
+	CHECK_EQ(hex("zz", buf, sizeof(buf)), 0);
+	CHECK_EQ(hex("0011223344556677 88", buf, sizeof(buf)), 0);	// too long
+	CHECK_EQ(hex("", buf, sizeof(buf)), 0);
+
+	out_len = 0;
+	CHECK(cmd_execute(table, CMD_COUNT(table), "echo 1 0x10 4294967295 4294967296 7", &sink));
+	CHECK(strcmp(out_buf, "1;16;4294967295;") == 0);
+	out_len = 0;
+	CHECK(cmd_execute(table, CMD_COUNT(table), "LED10 ON", &sink));
+	CHECK(cmd_execute(table, CMD_COUNT(table), "led1 off", &sink));
+	CHECK(cmd_execute(table, CMD_COUNT(table), "Led1 maybe", &sink));
+	CHECK(strcmp(out_buf, "onoff?") == 0);
+	CHECK(!cmd_execute(table, CMD_COUNT(table), "LED", &sink));
+	CHECK(!cmd_execute(table, CMD_COUNT(table), "LED100", &sink));
+	CHECK(cmd_execute(table, CMD_COUNT(table), "   ", &sink));	// empty line
+
+	char big[200];
+	memset(big, 'x', sizeof(big) - 1);
+	big[sizeof(big) - 1] = '\0';
+	out_len = 0;
+	cmd_printf(&sink, "%s", big);
+	CHECK_EQ(out_len, CMD_PRINTF_LEN - 1);	// truncated, not overrun
+	TEST_END();
+}
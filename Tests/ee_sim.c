@@ -0,0 +1,202 @@
+/*
+ * ee_sim.c
+ *
+ * Host 24C32 I2C EEPROM, see ee_sim.h.
+ */
+#include <string.h>
+#include "ee_sim.h"
+
+#define EE_SIM_ADDR 0xA0
+
+I2C_HandleTypeDef ee_sim_i2c;
+uint8_t ee_sim_mem[EE_SIM_SIZE];
+uint32_t ee_sim_page_writes[EE_SIM_PAGES];
+uint32_t ee_sim_nacks;
+
+static uint8_t present = 1;
+static uint8_t powered = 1;
+static uint8_t cut_armed;
+static uint32_t cut_left;
+static uint64_t busy_until; // end of the write cycle;
+
+/* Interrupt transfer accepted by the HAL and waiting for ee_sim_run */
+enum {
+	OP_NONE,
+	OP_TX,
+	OP_MEM_TX,
+	OP_MEM_RX,
+	OP_NACK,
+};
+
+static struct {
+	I2C_HandleTypeDef *hi2c;
+	uint8_t op;
+	uint16_t addr;
+	uint8_t *data;
+	uint16_t len;
+} it;
+
+void ee_sim_clear(void) {
+	memset(ee_sim_mem, 0xFF, sizeof(ee_sim_mem));
+	memset(ee_sim_page_writes, 0, sizeof(ee_sim_page_writes));
+	memset(&it, 0, sizeof(it));
+	ee_sim_nacks = 0;
+	present = 1;
+	powered = 1;
+	cut_armed = 0;
+	busy_until = 0;
+}
+
+void ee_sim_present(uint8_t p) {
+	present = p;
+}
+
+void ee_sim_power_cut(uint32_t n) {
+	cut_armed = 1;
+	cut_left = n;
+}
+
+void ee_sim_power_on(void) {
+	powered = 1;
+	cut_armed = 0;
+	busy_until = 0;
+	memset(&it, 0, sizeof(it));
+}
+
+uint8_t ee_sim_pending(void) {
+	return it.op != OP_NONE;
+}
+
+/* Start condition plus address byte, 1 when the device ACKs */
+static uint8_t ee_sim_select(uint16_t dev) {
+	mock_us += EE_SIM_BYTE_US;
+	if (present && powered && (dev & 0xFE) == EE_SIM_ADDR && mock_us >= busy_until)
+		return 1;
+	ee_sim_nacks++;
+	return 0;
+}
+
+/* Page write: the address counter wraps inside the page */
+static void ee_sim_store(uint16_t addr, const uint8_t *data, uint16_t len) {
+	uint16_t page = addr & ~(EE_SIM_PAGE - 1) & (EE_SIM_SIZE - 1);
+
+	mock_us += (2 + len) * EE_SIM_BYTE_US;
+	for (uint16_t i = 0; i < len; i++) {
+		if (cut_armed && cut_left-- == 0) {
+			powered = 0;
+			break;
+		}
+		ee_sim_mem[page + ((addr + i) & (EE_SIM_PAGE - 1))] = data[i];
+	}
+	ee_sim_page_writes[page / EE_SIM_PAGE]++;
+	busy_until = mock_us + EE_SIM_WRITE_US;
+}
+
+/* Sequential read, the address counter wraps at the end of the array */
+static void ee_sim_load(uint16_t addr, uint8_t *data, uint16_t len) {
+	mock_us += (3 + len) * EE_SIM_BYTE_US;
+	for (uint16_t i = 0; i < len; i++)
+		data[i] = ee_sim_mem[(addr + i) & (EE_SIM_SIZE - 1)];
+}
+
+static HAL_StatusTypeDef ee_sim_nack(I2C_HandleTypeDef *hi2c) {
+	hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+	return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint32_t Trials, uint32_t Timeout) {
+	if (it.op != OP_NONE) return HAL_BUSY;
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	while (Trials--)
+		if (ee_sim_select(DevAddress)) return HAL_OK;
+	return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+		uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+	if (it.op != OP_NONE) return HAL_BUSY;
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	if (!ee_sim_select(DevAddress)) return ee_sim_nack(hi2c);
+	ee_sim_store(MemAddress, pData, Size);
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+		uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+	if (it.op != OP_NONE) return HAL_BUSY;
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	if (!ee_sim_select(DevAddress)) return ee_sim_nack(hi2c);
+	ee_sim_load(MemAddress, pData, Size);
+	return HAL_OK;
+}
+
+/* A NACKed address of a plain transmit ends in the error interrupt */
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size) {
+	if (it.op != OP_NONE) return HAL_BUSY;
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	it.hi2c = hi2c;
+	it.op = ee_sim_select(DevAddress) ? OP_TX : OP_NACK;
+	it.len = Size;
+	return HAL_OK;
+}
+
+/* The F0 HAL sends the memory address blocking, a NACK there fails the call */
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+		uint16_t MemAddSize, uint8_t *pData, uint16_t Size) {
+	if (it.op != OP_NONE) return HAL_BUSY;
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	if (!ee_sim_select(DevAddress)) return ee_sim_nack(hi2c);
+	it.hi2c = hi2c;
+	it.op = OP_MEM_TX;
+	it.addr = MemAddress;
+	it.data = pData;
+	it.len = Size;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+		uint16_t MemAddSize, uint8_t *pData, uint16_t Size) {
+	if (it.op != OP_NONE) return HAL_BUSY;
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	if (!ee_sim_select(DevAddress)) return ee_sim_nack(hi2c);
+	it.hi2c = hi2c;
+	it.op = OP_MEM_RX;
+	it.addr = MemAddress;
+	it.data = pData;
+	it.len = Size;
+	return HAL_OK;
+}
+
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef *hi2c) {
+	return hi2c->ErrorCode;
+}
+
+uint32_t ee_sim_run(void) {
+	uint32_t n = 0;
+
+	while (it.op != OP_NONE) {
+		uint8_t op = it.op;
+
+		it.op = OP_NONE; // the callback may start the next transfer;
+		n++;
+		switch (op) {
+		case OP_TX:
+			mock_us += it.len * EE_SIM_BYTE_US;
+			HAL_I2C_MasterTxCpltCallback(it.hi2c);
+			break;
+		case OP_MEM_TX:
+			ee_sim_store(it.addr, it.data, it.len);
+			HAL_I2C_MemTxCpltCallback(it.hi2c);
+			break;
+		case OP_MEM_RX:
+			ee_sim_load(it.addr, it.data, it.len);
+			HAL_I2C_MemRxCpltCallback(it.hi2c);
+			break;
+		case OP_NACK:
+			it.hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+			HAL_I2C_ErrorCallback(it.hi2c);
+			break;
+		}
+	}
+	return n;
+}
@@ -0,0 +1,41 @@
+/*
+ * ee_sim.h
+ *
+ * Host 24C32 I2C EEPROM behind the mock HAL I2C calls: 32 byte pages that
+ * wrap, a write cycle during which the device NACKs its address, and bus
+ * time that moves mock_us. Interrupt transfers complete in ee_sim_run(),
+ * which calls the HAL callbacks the way the I2C interrupt would.
+ */
+
+#ifndef EE_SIM_H_
+#define EE_SIM_H_
+
+#include <stdint.h>
+#include "stm32f0xx_hal.h"
+
+#define EE_SIM_SIZE 4096
+#define EE_SIM_PAGE 32
+#define EE_SIM_PAGES (EE_SIM_SIZE / EE_SIM_PAGE)
+#define EE_SIM_WRITE_US 5000
+#define EE_SIM_BYTE_US 90 // 9 clocks at 100 kHz;
+
+extern I2C_HandleTypeDef ee_sim_i2c;
+extern uint8_t ee_sim_mem[EE_SIM_SIZE];
+/* Write cycles each page went through */
+extern uint32_t ee_sim_page_writes[EE_SIM_PAGES];
+/* Address NACKs seen, i.e. transfers that hit a write cycle */
+extern uint32_t ee_sim_nacks;
+
+/* Blank (0xFF) part, counters cleared, device present and powered */
+void ee_sim_clear(void);
+/* Without the device every address is NACKed */
+void ee_sim_present(uint8_t present);
+/* Power fails after n more data bytes reach the array: the write in
+ * progress is torn there and the device stays silent until power_on */
+void ee_sim_power_cut(uint32_t n);
+void ee_sim_power_on(void);
+/* Completes interrupt transfers until none is pending, returns how many */
+uint32_t ee_sim_run(void);
+uint8_t ee_sim_pending(void);
+
+#endif /* EE_SIM_H_ */
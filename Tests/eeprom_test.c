@@ -0,0 +1,167 @@
+/*
+ * eeprom_test.c
+ *
+ * Cv_05 eeprom.c against the simulated 24C32: blocking and interrupt
+ * driven transfers across page boundaries, ACK polling through write
+ * cycles, the busy guard, and a missing device.
+ */
+#include <stdint.h>
+#include <string.h>
+#include "eeprom.h"
+#include "ee_sim.h"
+#include "test.h"
+
+static uint8_t done_cnt;
+static HAL_StatusTypeDef done_status;
+
+static void done(HAL_StatusTypeDef status) {
+	done_cnt++;
+	done_status = status;
+}
+
+static void fill(uint8_t *buf, uint16_t len, uint8_t seed) {
+	for (uint16_t i = 0; i < len; i++)
+		buf[i] = seed + i * 7;
+}
+
+/* Pages a write of len bytes at addr goes through */
+static uint32_t pages(uint16_t addr, uint16_t len) {
+	return (addr + len - 1) / EE_SIM_PAGE - addr / EE_SIM_PAGE + 1;
+}
+
+static uint32_t total_writes(void) {
+	uint32_t n = 0;
+	for (uint16_t p = 0; p < EE_SIM_PAGES; p++)
+		n += ee_sim_page_writes[p];
+	return n;
+}
+
+/* Back to back blocking writes poll through each write cycle */
+static void test_blocking(void) {
+	uint8_t out[100], in[100];
+
+	ee_sim_clear();
+	fill(out, sizeof(out), 0x11);
+	CHECK_EQ(eeprom_write(0x1F0, out, sizeof(out)), HAL_OK);
+	CHECK_EQ(total_writes(), pages(0x1F0, sizeof(out)));
+	CHECK_EQ(ee_sim_page_writes[0x1F0 / EE_SIM_PAGE], 1);
+	CHECK(!memcmp(&ee_sim_mem[0x1F0], out, sizeof(out)));
+	CHECK_EQ(ee_sim_mem[0x1EF], 0xFF);
+	CHECK_EQ(ee_sim_mem[0x1F0 + sizeof(out)], 0xFF);
+	CHECK(ee_sim_nacks > 0);
+
+	memset(in, 0, sizeof(in));
+	CHECK_EQ(eeprom_read(0x1F0, in, sizeof(in)), HAL_OK);
+	CHECK(!memcmp(in, out, sizeof(out)));
+
+	CHECK_EQ(eeprom_write(EEPROM_SIZE - 4, out, 5), HAL_ERROR);
+	CHECK_EQ(eeprom_read(EEPROM_SIZE - 4, in, 5), HAL_ERROR);
+	CHECK_EQ(eeprom_write(EEPROM_SIZE - 5, out, 5), HAL_OK);
+}
+
+static HAL_StatusTypeDef run_write(uint16_t addr, const uint8_t *buf, uint16_t len) {
+	HAL_StatusTypeDef status;
+
+	done_cnt = 0;
+	status = eeprom_write_start(addr, buf, len, done);
+	if (status != HAL_OK) return status;
+	CHECK(eeprom_busy());
+	ee_sim_run();
+	CHECK_EQ(done_cnt, 1);
+	CHECK(!eeprom_busy());
+	return done_status;
+}
+
+static HAL_StatusTypeDef run_read(uint16_t addr, uint8_t *buf, uint16_t len) {
+	HAL_StatusTypeDef status;
+
+	done_cnt = 0;
+	status = eeprom_read_start(addr, buf, len, done);
+	if (status != HAL_OK) return status;
+	ee_sim_run();
+	CHECK_EQ(done_cnt, 1);
+	return done_status;
+}
+
+/* Pages chained from the interrupt, each one ACK-polled first */
+static void test_async(void) {
+	uint8_t out[150], in[150];
+	uint64_t t0;
+
+	ee_sim_clear();
+	fill(out, sizeof(out), 0x5A);
+	t0 = mock_us;
+	CHECK_EQ(run_write(0x305, out, sizeof(out)), HAL_OK);
+	CHECK_EQ(total_writes(), pages(0x305, sizeof(out)));
+	CHECK(!memcmp(&ee_sim_mem[0x305], out, sizeof(out)));
+	CHECK_EQ(ee_sim_mem[0x304], 0xFF);
+	CHECK_EQ(ee_sim_mem[0x305 + sizeof(out)], 0xFF);
+	/* every page but the last waited out the cycle of the one before */
+	CHECK(mock_us - t0 >= (pages(0x305, sizeof(out)) - 1) * EE_SIM_WRITE_US);
+	CHECK(ee_sim_nacks > 0);
+
+	/* the read right after polls through the last write cycle */
+	memset(in, 0, sizeof(in));
+	CHECK_EQ(run_read(0x305, in, sizeof(in)), HAL_OK);
+	CHECK(!memcmp(in, out, sizeof(out)));
+
+	/* single byte, page aligned full page */
+	CHECK_EQ(run_write(0x000, out, 1), HAL_OK);
+	CHECK_EQ(run_write(0x020, out, EE_SIM_PAGE), HAL_OK);
+	CHECK_EQ(ee_sim_page_writes[0], 1);
+	CHECK_EQ(ee_sim_page_writes[1], 1);
+	CHECK(!memcmp(&ee_sim_mem[0x020], out, EE_SIM_PAGE));
+
+	CHECK_EQ(eeprom_write_start(0, out, 0, done), HAL_ERROR);
+	CHECK_EQ(eeprom_read_start(EEPROM_SIZE - 1, in, 2, done), HAL_ERROR);
+}
+
+/* Nothing else gets on the bus while a transfer runs */
+static void test_busy(void) {
+	uint8_t out[40], in[4];
+
+	ee_sim_clear();
+	fill(out, sizeof(out), 1);
+	done_cnt = 0;
+	CHECK_EQ(eeprom_write_start(0x100, out, sizeof(out), done), HAL_OK);
+	CHECK_EQ(eeprom_write_start(0x200, out, 1, done), HAL_BUSY);
+	CHECK_EQ(eeprom_read_start(0x200, in, 1, done), HAL_BUSY);
+	CHECK_EQ(eeprom_read(0x200, in, 1), HAL_BUSY);
+	CHECK_EQ(eeprom_write(0x200, out, 1), HAL_BUSY);
+	ee_sim_run();
+	CHECK_EQ(done_cnt, 1);
+	CHECK_EQ(done_status, HAL_OK);
+	CHECK(!memcmp(&ee_sim_mem[0x100], out, sizeof(out)));
+	CHECK_EQ(eeprom_read(0x100, in, sizeof(in)), HAL_OK);
+	CHECK(!memcmp(in, out, sizeof(in)));
+}
+
+/* A missing device fails after the poll budget, and frees the driver */
+static void test_absent(void) {
+	uint8_t out[4] = { 1, 2, 3, 4 }, in[4];
+	uint32_t nacks;
+
+	ee_sim_clear();
+	ee_sim_present(0);
+	CHECK_EQ(eeprom_write(0, out, sizeof(out)), HAL_TIMEOUT);
+	CHECK_EQ(eeprom_read(0, in, sizeof(in)), HAL_TIMEOUT);
+
+	nacks = ee_sim_nacks;
+	CHECK_EQ(run_write(0, out, sizeof(out)), HAL_ERROR);
+	CHECK_EQ(ee_sim_nacks - nacks, EEPROM_IT_TRIES);
+	CHECK_EQ(run_read(0, in, sizeof(in)), HAL_ERROR);
+	CHECK_EQ(total_writes(), 0);
+
+	ee_sim_present(1);
+	CHECK_EQ(run_write(0, out, sizeof(out)), HAL_OK);
+	CHECK(!memcmp(ee_sim_mem, out, sizeof(out)));
+}
+
+int main(void) {
+	eeprom_init(&ee_sim_i2c);
+	test_blocking();
+	test_async();
+	test_busy();
+	test_absent();
+	TEST_END();
+}
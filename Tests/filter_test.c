@@ -0,0 +1,56 @@
+/*
+ * filter_test.c
+ *
+ * Common/Src/filter.c against the vectors in vectors/filter_vectors.h.
+ * Channel 0 of the interleaved trace is fed in blocks of several sizes;
+ * whatever the split, the value returned at the end of a block must be the
+ * per-sample reference output at that sample.
+ */
+#include <stdint.h>
+#include "filter.h"
+#include "test.h"
+#include "vectors/filter_vectors.h"
+
+static const uint32_t blocks[] = { 1, 2, 3, 7, 16, 64, VEC_N };
+
+int main(void) {
+	for (uint32_t b = 0; b < sizeof(blocks) / sizeof(blocks[0]); b++) {
+		filter_ema_t ema;
+		filter_ma_t ma;
+		filter_median_t med;
+		filter_cic_t cic;
+		uint16_t cic_out[VEC_N];
+		uint32_t cic_cnt = 0;
+
+		filter_ema_init(&ema, VEC_EMA_SHIFT, VEC_INIT);
+		filter_ma_init(&ma, VEC_MA_LEN, VEC_INIT);
+		filter_median_init(&med, VEC_MEDIAN_LEN, VEC_INIT);
+		filter_cic_init(&cic, VEC_CIC_LOG2);
+
+		for (uint32_t i = 0; i < VEC_N; i += blocks[b]) {
+			uint32_t n = VEC_N - i < blocks[b] ? VEC_N - i : blocks[b];
+			const uint16_t *x = &vec_adc[i * VEC_CH];
+			uint32_t last = i + n - 1;
+
+			CHECK_EQ(filter_ema_block(&ema, x, n, VEC_CH), vec_ema[last]);
+			CHECK_EQ(filter_ma_block(&ma, x, n, VEC_CH), vec_ma[last]);
+			CHECK_EQ(filter_median_block(&med, x, n, VEC_CH), vec_median[last]);
+			cic_cnt += filter_cic_block(&cic, x, n, VEC_CH, &cic_out[cic_cnt]);
+		}
+		CHECK_EQ(cic_cnt, sizeof(vec_cic) / sizeof(vec_cic[0]));
+		for (uint32_t i = 0; i < cic_cnt; i++)
+			CHECK_EQ(cic_out[i], vec_cic[i]);
+	}
+
+	/* Out-of-range lengths fall back to the maximum, even median lengths
+	 * round down to odd */
+	filter_ma_t ma;
+	filter_median_t med;
+	filter_ma_init(&ma, 0, 100);
+	CHECK_EQ(ma.len, FILTER_MA_MAX);
+	filter_median_init(&med, 0, 100);
+	CHECK_EQ(med.len, FILTER_MEDIAN_MAX);
+	filter_median_init(&med, 4, 100);
+	CHECK_EQ(med.len, 3);
+	TEST_END();
+}
@@ -0,0 +1,262 @@
+/*
+ * kv_test.c
+ *
+ * Cv_05 kv.c on the simulated 24C32: values survive a restart, writes
+ * spread over every page of the store, and a power cut at any byte of an
+ * append or a compaction leaves each key with its old or its new value.
+ */
+#include <stdint.h>
+#include <string.h>
+#include "kv.h"
+#include "ee_sim.h"
+#include "test.h"
+
+#define KEYS 6
+
+/* What the store should hold, len 0 for a missing key */
+static uint8_t model[KV_MAX_KEYS][KV_MAX_LEN];
+static uint8_t model_len[KV_MAX_KEYS];
+
+static void value_make(uint8_t *buf, uint8_t len, uint32_t seed) {
+	for (uint8_t i = 0; i < len; i++)
+		buf[i] = seed * 31 + i * 7;
+}
+
+static HAL_StatusTypeDef set(uint8_t key, uint8_t len, uint32_t seed) {
+	uint8_t buf[KV_MAX_LEN];
+	HAL_StatusTypeDef status;
+
+	value_make(buf, len, seed);
+	status = kv_set(key, buf, len);
+	if (status == HAL_OK) {
+		memcpy(model[key], buf, len);
+		model_len[key] = len;
+	}
+	return status;
+}
+
+static uint8_t matches(uint8_t key, const uint8_t *value, uint8_t value_len) {
+	uint8_t buf[KV_MAX_LEN], len = 0;
+
+	if (kv_get(key, buf, sizeof(buf), &len) != HAL_OK)
+		return value_len == 0;
+	return len == value_len && !memcmp(buf, value, len);
+}
+
+static void check_model(void) {
+	for (uint8_t k = 0; k < KV_MAX_KEYS; k++)
+		CHECK(matches(k, model[k], model_len[k]));
+}
+
+static void store_clear(void) {
+	ee_sim_clear();
+	memset(model_len, 0, sizeof(model_len));
+	CHECK_EQ(kv_init(), HAL_OK);
+}
+
+static void test_basic(void) {
+	store_clear();
+	check_model();
+	CHECK_EQ(set(3, 4, 1), HAL_OK);
+	CHECK_EQ(set(0, KV_MAX_LEN, 2), HAL_OK);
+	CHECK_EQ(set(3, 1, 3), HAL_OK);
+	check_model();
+
+	CHECK_EQ(kv_delete(0), HAL_OK);
+	model_len[0] = 0;
+	CHECK_EQ(kv_delete(5), HAL_OK); // not set, nothing to do;
+	CHECK_EQ(set(KV_MAX_KEYS, 1, 0), HAL_ERROR);
+	CHECK_EQ(set(1, KV_MAX_LEN + 1, 0), HAL_ERROR);
+	check_model();
+
+	CHECK_EQ(kv_init(), HAL_OK); // restart;
+	check_model();
+}
+
+/* Without the part nothing is touched until kv_init succeeds */
+static void test_no_device(void) {
+	uint8_t buf[4], len;
+
+	ee_sim_clear();
+	ee_sim_present(0);
+	CHECK_EQ(kv_init(), HAL_ERROR);
+	CHECK(!kv_ready());
+	ee_sim_present(1);
+	CHECK_EQ(kv_set(1, buf, sizeof(buf)), HAL_ERROR);
+	CHECK_EQ(kv_get(1, buf, sizeof(buf), &len), HAL_ERROR);
+	for (uint16_t p = 0; p < EE_SIM_PAGES; p++)
+		CHECK_EQ(ee_sim_page_writes[p], 0);
+	CHECK_EQ(kv_init(), HAL_OK);
+	CHECK(kv_ready());
+}
+
+/* Many updates of a few keys, every page of the store takes its share */
+static void test_wear(void) {
+	const uint16_t first = KV_BASE / EE_SIM_PAGE, per_sector = KV_SECTOR_SIZE / EE_SIM_PAGE;
+	const uint32_t updates = 20000;
+	uint32_t total = 0, max = 0, sector_min = UINT32_MAX, sector_max = 0;
+
+	store_clear();
+	for (uint32_t i = 0; i < updates; i++)
+		CHECK_EQ(set(i % KEYS, 1 + i % 8, i), HAL_OK);
+	check_model();
+	CHECK_EQ(kv_init(), HAL_OK);
+	check_model();
+
+	for (uint16_t p = 0; p < first; p++)
+		CHECK_EQ(ee_sim_page_writes[p], 0);
+	for (uint16_t s = 0; s < KV_SECTORS; s++) {
+		uint32_t sum = 0;
+		for (uint16_t p = first + s * per_sector; p < first + (s + 1) * per_sector; p++) {
+			sum += ee_sim_page_writes[p];
+			if (ee_sim_page_writes[p] > max) max = ee_sim_page_writes[p];
+		}
+		total += sum;
+		if (sum < sector_min) sector_min = sum;
+		if (sum > sector_max) sector_max = sum;
+	}
+	printf("kv %u updates: %u page writes, %u..%u per sector, %u at most per page\n",
+			(unsigned) updates, (unsigned) total, (unsigned) sector_min, (unsigned) sector_max,
+			(unsigned) max);
+	/* the sectors take turns; inside one, the records kept across
+	 * compactions sit on the first page and are rewritten less often */
+	CHECK(sector_max - sector_min <= sector_max / 20);
+	CHECK(max <= 2 * total / (KV_SECTORS * per_sector));
+	/* a fixed slot per key would put every update on one page */
+	CHECK(max < updates / 20);
+}
+
+/* Only a compaction writes a sector header, appends start behind it */
+static uint8_t headers_changed(const uint8_t *image) {
+	for (uint16_t a = KV_BASE; a < EE_SIM_SIZE; a += KV_SECTOR_SIZE)
+		if (memcmp(&image[a], &ee_sim_mem[a], 5))
+			return 1;
+	return 0;
+}
+
+/* Same crc as kv.c: 8 bit, polynomial 0x07 */
+static uint8_t crc8(const uint8_t *p, uint16_t len) {
+	uint8_t crc = 0;
+	while (len--) {
+		crc ^= *p++;
+		for (uint8_t i = 0; i < 8; i++)
+			crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+	}
+	return crc;
+}
+
+/* Puts a valid record of key right behind where an append of len bytes
+ * will end, as an older round could have left it. Only the terminator
+ * written ahead of the record keeps it from coming back. */
+static void plant_stale(uint8_t key, uint8_t len) {
+	uint16_t base = 0, best = 0, pos;
+	uint8_t found = 0;
+
+	for (uint16_t a = KV_BASE; a < EE_SIM_SIZE; a += KV_SECTOR_SIZE) {
+		uint8_t *h = &ee_sim_mem[a];
+		uint16_t seq = (h[2] << 8) | h[3];
+		if (h[0] != 0x4B || h[1] != 0x56 || crc8(h, 4) != h[4]) continue;
+		if (!found || (int16_t) (seq - best) > 0) {
+			base = a;
+			best = seq;
+			found = 1;
+		}
+	}
+	CHECK(found);
+	for (pos = 5; ee_sim_mem[base + pos] != 0xFF; pos += 3 + ee_sim_mem[base + pos + 1])
+		;
+	pos += 3 + len;
+	if (pos + 5 > KV_SECTOR_SIZE - 1) return; // this one compacts;
+	ee_sim_mem[base + pos] = key;
+	ee_sim_mem[base + pos + 1] = 2;
+	ee_sim_mem[base + pos + 2] = 0xEE;
+	ee_sim_mem[base + pos + 3] = 0xEE;
+	ee_sim_mem[base + pos + 4] = crc8(&ee_sim_mem[base + pos], 4);
+}
+
+/* Cuts the power at every byte of setting key, restarting after each */
+static void torn(const char *name, uint8_t key, uint8_t len, uint32_t seed) {
+	static uint8_t image[EE_SIM_SIZE];
+	uint8_t old[KV_MAX_LEN], old_len = model_len[key], fresh[KV_MAX_LEN];
+	uint32_t cuts = 0, got_new = 0;
+
+	plant_stale(key, len);
+	memcpy(image, ee_sim_mem, sizeof(image));
+	memcpy(old, model[key], old_len);
+	value_make(fresh, len, seed);
+	for (uint32_t n = 0;; n++) {
+		HAL_StatusTypeDef status;
+
+		memcpy(ee_sim_mem, image, sizeof(image));
+		ee_sim_power_on();
+		CHECK_EQ(kv_init(), HAL_OK);
+		ee_sim_power_cut(n);
+		status = kv_set(key, fresh, len);
+		ee_sim_power_on();
+		CHECK_EQ(kv_init(), HAL_OK);
+
+		for (uint8_t k = 0; k < KV_MAX_KEYS; k++)
+			if (k != key)
+				CHECK(matches(k, model[k], model_len[k]));
+		if (matches(key, fresh, len))
+			got_new++;
+		else
+			CHECK(matches(key, old, old_len));
+		if (status == HAL_OK) {
+			CHECK(matches(key, fresh, len)); // acknowledged means stored;
+			break;
+		}
+		cuts++;
+	}
+	printf("kv torn %s: %u cut points\n", name, (unsigned) cuts);
+	CHECK(cuts > 0);
+	CHECK(got_new > 0);
+	memcpy(model[key], fresh, len);
+	model_len[key] = len;
+}
+
+static void test_torn(void) {
+	uint32_t seed = 100;
+
+	/* go round the sectors a few times so stale records lie ahead */
+	store_clear();
+	for (uint32_t i = 0; i < 2000; i++)
+		CHECK_EQ(set(i % KEYS, 4 + i % KEYS, seed++), HAL_OK);
+	/* right after a compaction, so the next updates append */
+	for (;;) {
+		static uint8_t image[EE_SIM_SIZE];
+
+		memcpy(image, ee_sim_mem, sizeof(image));
+		CHECK_EQ(set(0, 4, seed++), HAL_OK);
+		if (headers_changed(image)) break;
+	}
+	torn("append", 2, 9, seed++);
+	torn("delete", 1, 0, seed++);
+
+	/* append until the next update has to compact, then cut that one */
+	for (;;) {
+		static uint8_t image[EE_SIM_SIZE];
+		uint8_t old[KV_MAX_LEN], old_len = model_len[5];
+
+		memcpy(image, ee_sim_mem, sizeof(image));
+		memcpy(old, model[5], old_len);
+		CHECK_EQ(set(5, KV_MAX_LEN, seed++), HAL_OK);
+		if (headers_changed(image)) {
+			memcpy(ee_sim_mem, image, sizeof(image));
+			memcpy(model[5], old, old_len);
+			model_len[5] = old_len;
+			break;
+		}
+	}
+	torn("compaction", 5, KV_MAX_LEN, seed++);
+	check_model();
+}
+
+int main(void) {
+	eeprom_init(&ee_sim_i2c);
+	test_basic();
+	test_no_device();
+	test_wear();
+	test_torn();
+	TEST_END();
+}
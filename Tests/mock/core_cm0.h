@@ -0,0 +1,37 @@
+/*
+ * core_cm0.h
+ *
+ * Host stand-in for the CMSIS Cortex-M0 core header. The device header
+ * only needs the register qualifiers; the interrupt intrinsics become
+ * plain functions on a fake PRIMASK so drivers can run in the tests.
+ */
+
+#ifndef CORE_CM0_H_
+#define CORE_CM0_H_
+
+#include <stdint.h>
+
+#define __I     volatile const
+#define __O     volatile
+#define __IO    volatile
+#define __IM    volatile const
+#define __OM    volatile
+#define __IOM   volatile
+
+#define __STATIC_INLINE static inline
+#define __ALIGNED(x) __attribute__((aligned(x)))
+
+extern uint32_t mock_primask;
+extern uint32_t mock_wfi_count;
+
+static inline void __disable_irq(void) { mock_primask = 1; }
+static inline void __enable_irq(void) { mock_primask = 0; }
+static inline uint32_t __get_PRIMASK(void) { return mock_primask; }
+static inline void __set_PRIMASK(uint32_t v) { mock_primask = v; }
+static inline void __WFI(void) { mock_wfi_count++; }
+static inline void __DSB(void) { }
+static inline void __DMB(void) { }
+static inline void __ISB(void) { }
+static inline void __NOP(void) { }
+
+#endif /* CORE_CM0_H_ */
@@ -0,0 +1,46 @@
+/*
+ * hal_mock.c
+ *
+ * Peripheral registers and the HAL calls shared by the host tests.
+ */
+#include "stm32f0xx_hal.h"
+
+uint32_t mock_primask;
+uint32_t mock_wfi_count;
+uint64_t mock_us;
+
+GPIO_TypeDef mock_gpioa, mock_gpiob, mock_gpioc;
+RCC_TypeDef mock_rcc;
+TIM_TypeDef mock_tim16, mock_tim17;
+DMA_TypeDef mock_dma1;
+DMA_Channel_TypeDef mock_dma1_channel3;
+
+void (*mock_gpio_hook)(GPIO_TypeDef *port, uint32_t old_odr);
+
+void mock_gpio_bsrr(GPIO_TypeDef *port, uint32_t bsrr) {
+	uint32_t old = port->ODR;
+
+	port->ODR = (old & ~(bsrr >> 16)) | (bsrr & 0xFFFF); // set wins, as in the part;
+	if (mock_gpio_hook != NULL && port->ODR != old)
+		mock_gpio_hook(port, old);
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state) {
+	mock_gpio_bsrr(port, state ? pin : (uint32_t) pin << 16);
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin) {
+	return (port->IDR & pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *port, uint16_t pin) {
+	HAL_GPIO_WritePin(port, pin, (port->ODR & pin) ? GPIO_PIN_RESET : GPIO_PIN_SET);
+}
+
+uint32_t HAL_GetTick(void) {
+	return mock_us / 1000;
+}
+
+void HAL_Delay(uint32_t ms) {
+	mock_us += (uint64_t) (ms + 1) * 1000; // HAL_Delay waits one tick more;
+}
@@ -0,0 +1,23 @@
+/*
+ * hal_mock_f4.c
+ *
+ * F4 GPIO for the host, outputs read back on IDR. Ports are shared by
+ * every thread of a test, hence the atomics.
+ */
+#include "stm32f4xx_hal.h"
+
+GPIO_TypeDef mock_f4_gpio[8];
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state) {
+	if (state == GPIO_PIN_SET) {
+		__atomic_or_fetch(&port->ODR, pin, __ATOMIC_SEQ_CST);
+		__atomic_or_fetch(&port->IDR, pin, __ATOMIC_SEQ_CST);
+	} else {
+		__atomic_and_fetch(&port->ODR, ~pin, __ATOMIC_SEQ_CST);
+		__atomic_and_fetch(&port->IDR, ~pin, __ATOMIC_SEQ_CST);
+	}
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin) {
+	return (port->IDR & pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
@@ -0,0 +1,54 @@
+/*
+ * lwip/api.h
+ *
+ * Netconn calls of a TCP connection, served by net_sim.c. The far end
+ * of each connection is a test client, see net_sim.h.
+ */
+
+#ifndef LWIP_API_H_
+#define LWIP_API_H_
+
+#include "lwip/opt.h"
+
+#define NETCONN_NOFLAG 0x00
+#define NETCONN_NOCOPY 0x00
+#define NETCONN_COPY 0x01
+#define NETCONN_MORE 0x02
+#define NETCONN_DONTBLOCK 0x04
+
+enum netconn_type {
+	NETCONN_TCP = 0x10,
+};
+
+typedef struct {
+	u32_t addr;
+} ip_addr_t;
+
+#define IP_ADDR4(ip, a, b, c, d) ((ip)->addr = ((u32_t) (a) << 24) | ((b) << 16) | ((c) << 8) | (d))
+
+struct netconn;
+
+struct netbuf {
+	struct netbuf *next; // receive queue link;
+	u16_t len;
+	u8_t data[];
+};
+
+#define netconn_set_recvtimeout(conn, timeout) netconn_set_recvtimeout_(conn, timeout)
+
+struct netconn *netconn_new(enum netconn_type type);
+err_t netconn_delete(struct netconn *conn);
+err_t netconn_bind(struct netconn *conn, const ip_addr_t *addr, u16_t port);
+err_t netconn_listen(struct netconn *conn);
+err_t netconn_accept(struct netconn *conn, struct netconn **new_conn);
+err_t netconn_connect(struct netconn *conn, const ip_addr_t *addr, u16_t port);
+err_t netconn_recv(struct netconn *conn, struct netbuf **new_buf);
+err_t netconn_write(struct netconn *conn, const void *dataptr, size_t size, u8_t apiflags);
+err_t netconn_close(struct netconn *conn);
+void netconn_set_recvtimeout_(struct netconn *conn, int timeout);
+
+void netbuf_delete(struct netbuf *buf);
+err_t netbuf_data(struct netbuf *buf, void **dataptr, u16_t *len);
+s8_t netbuf_next(struct netbuf *buf);
+
+#endif /* LWIP_API_H_ */
@@ -0,0 +1,37 @@
+/*
+ * lwip/opt.h
+ *
+ * Host stand-in for the lwIP headers the Cv_12 netconn applications use,
+ * just the types and options they need. net_sim.c implements the calls
+ * on POSIX threads.
+ */
+
+#ifndef LWIP_OPT_H_
+#define LWIP_OPT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "main.h"
+
+#define LWIP_NETCONN 1
+#define LWIP_SO_RCVTIMEO 1
+#define TCP_MSS 536
+
+typedef uint8_t u8_t;
+typedef int8_t s8_t;
+typedef uint16_t u16_t;
+typedef int16_t s16_t;
+typedef uint32_t u32_t;
+typedef int32_t s32_t;
+typedef int8_t err_t;
+
+#define ERR_OK 0
+#define ERR_MEM -1
+#define ERR_TIMEOUT -3
+#define ERR_VAL -6
+#define ERR_CONN -11
+#define ERR_CLSD -15
+
+#define LWIP_UNUSED_ARG(x) (void)(x)
+
+#endif /* LWIP_OPT_H_ */
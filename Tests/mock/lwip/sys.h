@@ -0,0 +1,28 @@
+/*
+ * lwip/sys.h
+ *
+ * Semaphores and threads of the lwIP OS layer on POSIX, see net_sim.c
+ */
+
+#ifndef LWIP_SYS_H_
+#define LWIP_SYS_H_
+
+#include <semaphore.h>
+#include "lwip/opt.h"
+
+#define tskIDLE_PRIORITY 0
+#define SYS_ARCH_TIMEOUT 0xFFFFFFFFUL
+
+typedef struct {
+	sem_t sem;
+} sys_sem_t;
+typedef void *sys_thread_t;
+typedef void (*lwip_thread_fn)(void *arg);
+
+err_t sys_sem_new(sys_sem_t *sem, u8_t count);
+void sys_sem_signal(sys_sem_t *sem);
+u32_t sys_arch_sem_wait(sys_sem_t *sem, u32_t timeout); // timeout 0 waits forever;
+sys_thread_t sys_thread_new(const char *name, lwip_thread_fn thread, void *arg, int stacksize, int prio);
+u32_t sys_now(void);
+
+#endif /* LWIP_SYS_H_ */
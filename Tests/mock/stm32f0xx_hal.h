@@ -0,0 +1,116 @@
+/*
+ * stm32f0xx_hal.h
+ *
+ * Host stand-in for the HAL. The real device header supplies the register
+ * layouts and bit names, the peripherals themselves are plain structs in
+ * RAM (hal_mock.c) that the tests inspect and drive.
+ */
+
+#ifndef STM32F0XX_HAL_H_
+#define STM32F0XX_HAL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "stm32f030x8.h"
+
+#undef GPIOA
+#undef GPIOB
+#undef GPIOC
+#undef RCC
+#undef TIM16
+#undef TIM17
+#undef DMA1
+#undef DMA1_Channel3
+extern GPIO_TypeDef mock_gpioa, mock_gpiob, mock_gpioc;
+extern RCC_TypeDef mock_rcc;
+extern TIM_TypeDef mock_tim16, mock_tim17;
+extern DMA_TypeDef mock_dma1;
+extern DMA_Channel_TypeDef mock_dma1_channel3;
+#define GPIOA (&mock_gpioa)
+#define GPIOB (&mock_gpiob)
+#define GPIOC (&mock_gpioc)
+#define RCC (&mock_rcc)
+#define TIM16 (&mock_tim16)
+#define TIM17 (&mock_tim17)
+#define DMA1 (&mock_dma1)
+#define DMA1_Channel3 (&mock_dma1_channel3)
+
+typedef enum {
+	HAL_OK = 0x00U,
+	HAL_ERROR = 0x01U,
+	HAL_BUSY = 0x02U,
+	HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum {
+	GPIO_PIN_RESET = 0U,
+	GPIO_PIN_SET
+} GPIO_PinState;
+
+#define GPIO_PIN_0  ((uint16_t)0x0001U)
+#define GPIO_PIN_1  ((uint16_t)0x0002U)
+#define GPIO_PIN_2  ((uint16_t)0x0004U)
+#define GPIO_PIN_3  ((uint16_t)0x0008U)
+#define GPIO_PIN_4  ((uint16_t)0x0010U)
+#define GPIO_PIN_5  ((uint16_t)0x0020U)
+#define GPIO_PIN_6  ((uint16_t)0x0040U)
+#define GPIO_PIN_7  ((uint16_t)0x0080U)
+#define GPIO_PIN_8  ((uint16_t)0x0100U)
+#define GPIO_PIN_9  ((uint16_t)0x0200U)
+#define GPIO_PIN_10 ((uint16_t)0x0400U)
+#define GPIO_PIN_11 ((uint16_t)0x0800U)
+#define GPIO_PIN_12 ((uint16_t)0x1000U)
+#define GPIO_PIN_13 ((uint16_t)0x2000U)
+#define GPIO_PIN_14 ((uint16_t)0x4000U)
+#define GPIO_PIN_15 ((uint16_t)0x8000U)
+
+#define __HAL_RCC_TIM17_CLK_ENABLE() (RCC->APB2ENR |= RCC_APB2ENR_TIM17EN)
+
+/* Every pin change made through the HAL or mock_gpio_bsrr() is reported
+ * here, tests hook it to watch a bus. */
+extern void (*mock_gpio_hook)(GPIO_TypeDef *port, uint32_t old_odr);
+void mock_gpio_bsrr(GPIO_TypeDef *port, uint32_t bsrr);
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin);
+void HAL_GPIO_TogglePin(GPIO_TypeDef *port, uint16_t pin);
+
+/* Time only moves when a test or a simulator advances it */
+extern uint64_t mock_us;
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t ms);
+
+static inline void HAL_NVIC_SetPriority(IRQn_Type irq, uint32_t pre, uint32_t sub) { (void)irq; (void)pre; (void)sub; }
+static inline void HAL_NVIC_EnableIRQ(IRQn_Type irq) { (void)irq; }
+static inline void HAL_NVIC_DisableIRQ(IRQn_Type irq) { (void)irq; }
+
+/* I2C, implemented by whichever simulator the test links */
+#define HAL_I2C_ERROR_NONE 0x00000000U
+#define HAL_I2C_ERROR_BERR 0x00000001U
+#define HAL_I2C_ERROR_AF 0x00000004U
+#define HAL_I2C_ERROR_TIMEOUT 0x00000020U
+#define I2C_MEMADD_SIZE_8BIT 0x00000001U
+#define I2C_MEMADD_SIZE_16BIT 0x00000002U
+
+typedef struct {
+	I2C_TypeDef *Instance;
+	volatile uint32_t ErrorCode;
+} I2C_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint32_t Trials, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+		uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+		uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+		uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+		uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+
+#endif /* STM32F0XX_HAL_H_ */
@@ -0,0 +1,49 @@
+/*
+ * stm32f4xx_hal.h
+ *
+ * Just enough of the F4 HAL for the Cv_12 application code on the host:
+ * GPIO ports as plain structs, see hal_mock_f4.c.
+ */
+
+#ifndef STM32F4XX_HAL_H_
+#define STM32F4XX_HAL_H_
+
+#include <stdint.h>
+
+typedef struct {
+	volatile uint32_t IDR;
+	volatile uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef enum {
+	GPIO_PIN_RESET = 0,
+	GPIO_PIN_SET
+} GPIO_PinState;
+
+#define GPIO_PIN_0 ((uint16_t) 0x0001)
+#define GPIO_PIN_1 ((uint16_t) 0x0002)
+#define GPIO_PIN_2 ((uint16_t) 0x0004)
+#define GPIO_PIN_4 ((uint16_t) 0x0010)
+#define GPIO_PIN_5 ((uint16_t) 0x0020)
+#define GPIO_PIN_6 ((uint16_t) 0x0040)
+#define GPIO_PIN_7 ((uint16_t) 0x0080)
+#define GPIO_PIN_8 ((uint16_t) 0x0100)
+#define GPIO_PIN_9 ((uint16_t) 0x0200)
+#define GPIO_PIN_10 ((uint16_t) 0x0400)
+#define GPIO_PIN_11 ((uint16_t) 0x0800)
+#define GPIO_PIN_12 ((uint16_t) 0x1000)
+#define GPIO_PIN_13 ((uint16_t) 0x2000)
+#define GPIO_PIN_14 ((uint16_t) 0x4000)
+
+extern GPIO_TypeDef mock_f4_gpio[8];
+#define GPIOA (&mock_f4_gpio[0])
+#define GPIOB (&mock_f4_gpio[1])
+#define GPIOC (&mock_f4_gpio[2])
+#define GPIOD (&mock_f4_gpio[3])
+#define GPIOG (&mock_f4_gpio[6])
+#define GPIOH (&mock_f4_gpio[7])
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin);
+
+#endif /* STM32F4XX_HAL_H_ */
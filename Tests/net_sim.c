@@ -0,0 +1,318 @@
+/*
+ * net_sim.c
+ *
+ * Loopback TCP behind the mock netconn API, see net_sim.h. One lock and
+ * one condition guard everything, the tests are small.
+ */
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lwip/sys.h"
+#include "net_sim.h"
+
+#define NET_SIM_LISTENERS 8
+
+struct netconn {
+	u16_t port; // listening port, 0 for a connection;
+	struct netconn *accept_head, *accept_tail, *accept_next;
+	struct netbuf *rx_head, *rx_tail; // client to server;
+	char *tx; // server to client;
+	size_t tx_len, tx_cap, tx_read;
+	net_sim_tx_t stats;
+	int recv_timeout;
+	u8_t closed; // by the server;
+	u8_t hungup; // by the client;
+};
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t changed = PTHREAD_COND_INITIALIZER;
+static struct netconn *listeners[NET_SIM_LISTENERS];
+
+static void deadline(struct timespec *ts, int ms) {
+	clock_gettime(CLOCK_REALTIME, ts);
+	ts->tv_sec += ms / 1000;
+	ts->tv_nsec += (long) (ms % 1000) * 1000000;
+	if (ts->tv_nsec >= 1000000000) {
+		ts->tv_sec++;
+		ts->tv_nsec -= 1000000000;
+	}
+}
+
+/* Waits for a change, 0 once the deadline passed (ms 0 waits forever) */
+static int wait_change(int ms, const struct timespec *until) {
+	if (ms == 0) {
+		pthread_cond_wait(&changed, &lock);
+		return 1;
+	}
+	return pthread_cond_timedwait(&changed, &lock, until) != ETIMEDOUT;
+}
+
+/* --- lwIP side ----------------------------------------------------------- */
+
+err_t sys_sem_new(sys_sem_t *sem, u8_t count) {
+	return sem_init(&sem->sem, 0, count) ? ERR_MEM : ERR_OK;
+}
+
+void sys_sem_signal(sys_sem_t *sem) {
+	sem_post(&sem->sem);
+}
+
+u32_t sys_arch_sem_wait(sys_sem_t *sem, u32_t timeout) {
+	struct timespec ts;
+
+	if (timeout == 0) {
+		while (sem_wait(&sem->sem))
+			;
+		return 0;
+	}
+	deadline(&ts, timeout);
+	while (sem_timedwait(&sem->sem, &ts))
+		if (errno == ETIMEDOUT)
+			return SYS_ARCH_TIMEOUT;
+	return 0;
+}
+
+struct thread_start {
+	lwip_thread_fn fn;
+	void *arg;
+};
+
+static void *thread_main(void *p) {
+	struct thread_start start = *(struct thread_start *) p;
+
+	free(p);
+	start.fn(start.arg);
+	return NULL;
+}
+
+sys_thread_t sys_thread_new(const char *name, lwip_thread_fn thread, void *arg, int stacksize, int prio) {
+	struct thread_start *start = malloc(sizeof(*start));
+	pthread_t t;
+
+	start->fn = thread;
+	start->arg = arg;
+	if (pthread_create(&t, NULL, thread_main, start)) {
+		free(start);
+		return NULL;
+	}
+	pthread_detach(t);
+	return (sys_thread_t) t;
+}
+
+u32_t sys_now(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* Connections are never freed, a client may still hold one */
+struct netconn *netconn_new(enum netconn_type type) {
+	return calloc(1, sizeof(struct netconn));
+}
+
+err_t netconn_delete(struct netconn *conn) {
+	pthread_mutex_lock(&lock);
+	for (int i = 0; i < NET_SIM_LISTENERS; i++)
+		if (listeners[i] == conn)
+			listeners[i] = NULL;
+	conn->closed = 1;
+	pthread_cond_broadcast(&changed);
+	pthread_mutex_unlock(&lock);
+	return ERR_OK;
+}
+
+err_t netconn_bind(struct netconn *conn, const ip_addr_t *addr, u16_t port) {
+	conn->port = port;
+	return ERR_OK;
+}
+
+err_t netconn_listen(struct netconn *conn) {
+	err_t err = ERR_MEM;
+
+	pthread_mutex_lock(&lock);
+	for (int i = 0; i < NET_SIM_LISTENERS; i++)
+		if (listeners[i] == NULL) {
+			listeners[i] = conn;
+			err = ERR_OK;
+			break;
+		}
+	pthread_mutex_unlock(&lock);
+	return err;
+}
+
+err_t netconn_accept(struct netconn *conn, struct netconn **new_conn) {
+	pthread_mutex_lock(&lock);
+	while (conn->accept_head == NULL)
+		pthread_cond_wait(&changed, &lock);
+	*new_conn = conn->accept_head;
+	conn->accept_head = conn->accept_head->accept_next;
+	pthread_mutex_unlock(&lock);
+	return ERR_OK;
+}
+
+/* Nothing outside the loopback answers */
+err_t netconn_connect(struct netconn *conn, const ip_addr_t *addr, u16_t port) {
+	return ERR_CONN;
+}
+
+err_t netconn_recv(struct netconn *conn, struct netbuf **new_buf) {
+	struct timespec until;
+	err_t err = ERR_OK;
+
+	pthread_mutex_lock(&lock);
+	deadline(&until, conn->recv_timeout);
+	while (conn->rx_head == NULL && !conn->hungup && !conn->closed)
+		if (!wait_change(conn->recv_timeout, &until)) {
+			err = ERR_TIMEOUT;
+			break;
+		}
+	if (conn->rx_head != NULL) {
+		*new_buf = conn->rx_head;
+		conn->rx_head = conn->rx_head->next;
+		err = ERR_OK;
+	} else if (err == ERR_OK) {
+		err = ERR_CLSD;
+	}
+	pthread_mutex_unlock(&lock);
+	return err;
+}
+
+err_t netconn_write(struct netconn *conn, const void *dataptr, size_t size, u8_t apiflags) {
+	err_t err = ERR_OK;
+
+	pthread_mutex_lock(&lock);
+	if (conn->closed || conn->hungup) {
+		err = ERR_CLSD;
+	} else {
+		if (conn->tx_len + size > conn->tx_cap) {
+			conn->tx_cap = (conn->tx_len + size) * 2;
+			conn->tx = realloc(conn->tx, conn->tx_cap);
+		}
+		memcpy(conn->tx + conn->tx_len, dataptr, size);
+		conn->tx_len += size;
+		conn->stats.writes++;
+		conn->stats.segments += (size + TCP_MSS - 1) / TCP_MSS;
+		conn->stats.bytes += size;
+		pthread_cond_broadcast(&changed);
+	}
+	pthread_mutex_unlock(&lock);
+	return err;
+}
+
+err_t netconn_close(struct netconn *conn) {
+	pthread_mutex_lock(&lock);
+	conn->closed = 1;
+	pthread_cond_broadcast(&changed);
+	pthread_mutex_unlock(&lock);
+	return ERR_OK;
+}
+
+void netconn_set_recvtimeout_(struct netconn *conn, int timeout) {
+	conn->recv_timeout = timeout;
+}
+
+void netbuf_delete(struct netbuf *buf) {
+	free(buf);
+}
+
+err_t netbuf_data(struct netbuf *buf, void **dataptr, u16_t *len) {
+	*dataptr = buf->data;
+	*len = buf->len;
+	return ERR_OK;
+}
+
+s8_t netbuf_next(struct netbuf *buf) {
+	return -1; // one part per netbuf;
+}
+
+/* --- client side --------------------------------------------------------- */
+
+struct netconn *net_sim_connect(u16_t port) {
+	struct netconn *l = NULL, *c;
+
+	pthread_mutex_lock(&lock);
+	for (int i = 0; i < NET_SIM_LISTENERS; i++)
+		if (listeners[i] != NULL && listeners[i]->port == port)
+			l = listeners[i];
+	if (l == NULL) {
+		pthread_mutex_unlock(&lock);
+		return NULL;
+	}
+	c = calloc(1, sizeof(*c));
+	if (l->accept_head == NULL)
+		l->accept_head = c;
+	else
+		l->accept_tail->accept_next = c;
+	l->accept_tail = c;
+	pthread_cond_broadcast(&changed);
+	pthread_mutex_unlock(&lock);
+	return c;
+}
+
+void net_sim_send(struct netconn *c, const void *data, size_t len) {
+	struct netbuf *buf = malloc(sizeof(*buf) + len);
+
+	buf->next = NULL;
+	buf->len = len;
+	memcpy(buf->data, data, len);
+	pthread_mutex_lock(&lock);
+	if (c->closed || c->hungup) {
+		free(buf);
+	} else {
+		if (c->rx_head == NULL)
+			c->rx_head = buf;
+		else
+			c->rx_tail->next = buf;
+		c->rx_tail = buf;
+		pthread_cond_broadcast(&changed);
+	}
+	pthread_mutex_unlock(&lock);
+}
+
+size_t net_sim_read(struct netconn *c, char *buf, size_t len, int timeout_ms) {
+	struct timespec until;
+	size_t n;
+
+	pthread_mutex_lock(&lock);
+	deadline(&until, timeout_ms);
+	while (c->tx_len - c->tx_read < len && !c->closed)
+		if (timeout_ms == 0 || !wait_change(timeout_ms, &until))
+			break;
+	n = c->tx_len - c->tx_read;
+	if (n > len)
+		n = len;
+	memcpy(buf, c->tx + c->tx_read, n);
+	c->tx_read += n;
+	pthread_mutex_unlock(&lock);
+	return n;
+}
+
+uint8_t net_sim_closed(struct netconn *c, int timeout_ms) {
+	struct timespec until;
+	uint8_t closed;
+
+	pthread_mutex_lock(&lock);
+	deadline(&until, timeout_ms);
+	while (!c->closed)
+		if (timeout_ms == 0 || !wait_change(timeout_ms, &until))
+			break;
+	closed = c->closed;
+	pthread_mutex_unlock(&lock);
+	return closed;
+}
+
+void net_sim_hangup(struct netconn *c) {
+	pthread_mutex_lock(&lock);
+	c->hungup = 1;
+	pthread_cond_broadcast(&changed);
+	pthread_mutex_unlock(&lock);
+}
+
+void net_sim_tx(struct netconn *c, net_sim_tx_t *tx) {
+	pthread_mutex_lock(&lock);
+	*tx = c->stats;
+	pthread_mutex_unlock(&lock);
+}
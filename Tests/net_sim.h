@@ -0,0 +1,38 @@
+/*
+ * net_sim.h
+ *
+ * Loopback TCP for the netconn applications of Cv_12: the netconn and
+ * sys calls of mock/lwip run on POSIX threads, and test threads act as
+ * the clients. A client handle is the server side netconn itself.
+ *
+ * Segments are counted as if every netconn_write() were pushed out at
+ * once, in TCP_MSS pieces: the peer ACKs before the next write, so
+ * Nagle never gets to merge two writes. That is the worst case, and the
+ * usual one for a request/reply console.
+ */
+
+#ifndef NET_SIM_H_
+#define NET_SIM_H_
+
+#include <stddef.h>
+#include "lwip/api.h"
+
+typedef struct {
+	u32_t writes;
+	u32_t segments;
+	u32_t bytes;
+} net_sim_tx_t;
+
+/* NULL when nothing listens on port */
+struct netconn *net_sim_connect(u16_t port);
+void net_sim_send(struct netconn *c, const void *data, size_t len);
+/* Waits up to timeout_ms (0 does not wait) for len bytes from the
+ * server, returns how many came before that or before the server closed */
+size_t net_sim_read(struct netconn *c, char *buf, size_t len, int timeout_ms);
+/* 1 once the server has closed its side, what it sent is still readable */
+uint8_t net_sim_closed(struct netconn *c, int timeout_ms);
+/* The client closes its side */
+void net_sim_hangup(struct netconn *c);
+void net_sim_tx(struct netconn *c, net_sim_tx_t *tx);
+
+#endif /* NET_SIM_H_ */
@@ -0,0 +1,148 @@
+/*
+ * ow_async_test.c
+ *
+ * The timer-driven 1-Wire engine of Cv_06 against the bus simulator:
+ * convert + scratchpad reads for one and several sensors, CRC errors, an
+ * empty bus, and slot timing checked on every edge.
+ */
+#include <stdint.h>
+#include "main.h"
+#include "1wire.h"
+#include "ow_sim.h"
+#include "test.h"
+
+static uint8_t done_cnt, done_ok;
+
+static void done(uint8_t ok) {
+	done_cnt++;
+	done_ok = ok;
+}
+
+static void rom_make(uint8_t rom[8], uint8_t family, uint64_t serial) {
+	rom[0] = family;
+	for (uint8_t i = 1; i < 7; i++, serial >>= 8)
+		rom[i] = serial & 0xFF;
+	ow_sim_rom_crc(rom);
+}
+
+static uint8_t read_temp(const uint8_t *rom, volatile int16_t *t) {
+	done_cnt = 0;
+	if (!OWReadTemperatureStart(rom, t, done)) return 0;
+	ow_sim_run_timer();
+	CHECK_EQ(done_cnt, 1);
+	CHECK(!OWBusy());
+	return done_ok;
+}
+
+static uint8_t convert(void) {
+	done_cnt = 0;
+	if (!OWConvertAllStart(done)) return 0;
+	ow_sim_run_timer();
+	CHECK_EQ(done_cnt, 1);
+	return done_ok;
+}
+
+/* One sensor addressed with skip ROM */
+static void test_single(void) {
+	uint8_t rom[8];
+	volatile int16_t t = 0;
+
+	ow_sim_clear();
+	rom_make(rom, DS18B20_SIG, 0x0000A1B2C3D4ULL);
+	ow_sim_add(rom, 0x0191);	// 25.0625 C
+	OWInit();
+	CHECK_EQ(OW_TIM->PSC, 47);
+
+	CHECK(read_temp(NULL, &t));
+	CHECK_EQ(t, 8500);	// power-on scratchpad before any conversion
+
+	CHECK(convert());
+	CHECK_EQ(ow_sim_conversions, 1);
+	CHECK(read_temp(NULL, &t));
+	CHECK_EQ(t, 8500);	// still converting
+	ow_sim_delay(CONVERT_T_DELAY * 1000);
+	CHECK(read_temp(NULL, &t));
+	CHECK_EQ(t, 2506);
+	CHECK_EQ(ow_sim_violations, 0);
+}
+
+/* Several sensors, one conversion, match ROM reads chained from done() */
+static uint8_t rom[4][8];
+static volatile int16_t temp[4];
+static uint8_t next;
+
+static void chain_done(uint8_t ok) {
+	CHECK(ok);
+	if (++next < 4)
+		CHECK(OWReadTemperatureStart(rom[next], &temp[next], chain_done));
+}
+
+static void test_multi(void) {
+	static const int16_t raw[4] = { 0x0191, -168, 0x07D0, 0x0008 };
+	static const int16_t want[4] = { 2506, -1050, 12500, 50 };
+
+	ow_sim_clear();
+	for (uint8_t i = 0; i < 4; i++) {
+		rom_make(rom[i], DS18B20_SIG, 0x100000000ULL * i + 0x55AA + i);
+		ow_sim_add(rom[i], raw[i]);
+	}
+	OWInit();
+	CHECK(convert());
+	CHECK(OWBusy() == 0);
+	CHECK(OWConvertAllStart(done));
+	CHECK(!OWConvertAllStart(done));	// busy
+	CHECK(!OWReadTemperatureStart(NULL, &temp[0], done));
+	ow_sim_run_timer();
+	ow_sim_delay(CONVERT_T_DELAY * 1000);
+
+	uint32_t t0 = ow_sim_now();
+	next = 0;
+	CHECK(OWReadTemperatureStart(rom[0], &temp[0], chain_done));
+	ow_sim_run_timer();
+	CHECK_EQ(next, 4);
+	for (uint8_t i = 0; i < 4; i++)
+		CHECK_EQ(temp[i], want[i]);
+	/* reset + 19 bytes of slots each, well under a CONVERT_T_DELAY */
+	CHECK(ow_sim_now() - t0 < 4 * (1000 + 19 * 8 * 75));
+	CHECK_EQ(ow_sim_violations, 0);
+}
+
+static void test_errors(void) {
+	uint8_t r[8];
+	volatile int16_t t = 1234;
+
+	/* Nobody on the bus: no presence pulse, result untouched */
+	ow_sim_clear();
+	OWInit();
+	CHECK(!read_temp(NULL, &t));
+	CHECK_EQ(t, 1234);
+	CHECK(!convert());
+	CHECK_EQ(ow_sim_violations, 0);
+
+	/* One flipped scratchpad bit */
+	ow_sim_clear();
+	rom_make(r, DS18B20_SIG, 42);
+	ow_sim_add(r, 0x0191);
+	OWInit();
+	CHECK(convert());
+	ow_sim_delay(CONVERT_T_DELAY * 1000);
+	ow_sim_corrupt(0);
+	CHECK(!read_temp(r, &t));
+	CHECK_EQ((uint16_t) t, OW_ERR_BADCRC);
+	CHECK(read_temp(r, &t));	// next read is clean again
+	CHECK_EQ(t, 2506);
+
+	/* Match ROM for a sensor that is not there: all ones, CRC fails */
+	uint8_t other[8];
+	rom_make(other, DS18B20_SIG, 43);
+	CHECK(!read_temp(other, &t));
+	CHECK_EQ((uint16_t) t, OW_ERR_BADCRC);
+	CHECK_EQ(ow_sim_violations, 0);
+}
+
+int main(void) {
+	test_single();
+	test_multi();
+	test_errors();
+	TEST_END();
+}
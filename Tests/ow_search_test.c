@@ -0,0 +1,110 @@
+/*
+ * ow_search_test.c
+ *
+ * OWFirst()/OWNext()/OWSearchAll() of Cv_06 against buses of simulated
+ * slaves: one to OW_SIM_MAX devices, ROMs that differ only in their last
+ * bits, foreign families, a full result table and an empty bus.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "main.h"
+#include "1wire.h"
+#include "ow_sim.h"
+#include "test.h"
+
+static uint8_t roms[OW_SIM_MAX][8];
+static uint8_t rom_cnt;
+
+static void bus(uint8_t family, const uint64_t *serials, uint8_t n) {
+	ow_sim_clear();
+	rom_cnt = n;
+	for (uint8_t i = 0; i < n; i++) {
+		uint64_t serial = serials[i];
+		roms[i][0] = family;
+		for (uint8_t b = 1; b < 7; b++, serial >>= 8)
+			roms[i][b] = serial & 0xFF;
+		ow_sim_rom_crc(roms[i]);
+		ow_sim_add(roms[i], 0);
+	}
+}
+
+static int on_bus(const uint8_t rom[8]) {
+	for (uint8_t i = 0; i < rom_cnt; i++)
+		if (memcmp(roms[i], rom, 8) == 0) return i;
+	return -1;
+}
+
+/* OWFirst/OWNext must list every ROM on the bus exactly once */
+static void check_enum(void) {
+	uint8_t rom[8], seen[OW_SIM_MAX] = { 0 };
+	uint8_t found = 0;
+	int8_t res;
+
+	for (res = OWFirst(rom); res == OW_FOUND; res = OWNext(rom)) {
+		int i = on_bus(rom);
+		CHECK(i >= 0);
+		if (i < 0 || found > OW_SIM_MAX) break;
+		CHECK_EQ(seen[i], 0);
+		seen[i] = 1;
+		found++;
+	}
+	CHECK_EQ(res, OW_NOMODULES);
+	CHECK_EQ(found, rom_cnt);
+	CHECK_EQ(OWNext(rom), OW_NOMODULES);	// stays exhausted
+	CHECK_EQ(ow_sim_violations, 0);
+}
+
+int main(void) {
+	uint64_t serials[OW_SIM_MAX];
+	uint8_t found[OW_SIM_MAX][8];
+
+	/* One device, then neighbours differing in a single low or high bit */
+	serials[0] = 0x123456789ABCULL;
+	bus(DS18B20_SIG, serials, 1);
+	OWInit();
+	check_enum();
+	serials[1] = serials[0] ^ 1;
+	serials[2] = serials[0] ^ (1ULL << 47);
+	bus(DS18B20_SIG, serials, 3);
+	check_enum();
+
+	/* Full bus of random serials, several seeds */
+	srand(7);
+	for (uint8_t round = 0; round < 20; round++) {
+		uint8_t n = 1 + round % OW_SIM_MAX;
+		for (uint8_t i = 0; i < n; i++)
+			serials[i] = ((uint64_t) rand() << 24 ^ rand()) & 0xFFFFFFFFFFFFULL;
+		bus(DS18B20_SIG, serials, n);
+		check_enum();
+	}
+
+	/* OWSearchAll keeps DS18B20 only and stops at max */
+	for (uint8_t i = 0; i < 6; i++)
+		serials[i] = 0x1000 + i * 0x111;
+	bus(DS18B20_SIG, serials, 6);
+	ow_sim_clear();
+	for (uint8_t i = 0; i < 6; i++) {
+		if (i == 2 || i == 4) {
+			roms[i][0] = 0x10;	// DS18S20
+			ow_sim_rom_crc(roms[i]);
+		}
+		ow_sim_add(roms[i], 0);
+	}
+	CHECK_EQ(OWSearchAll(found, OW_SIM_MAX), 4);
+	for (uint8_t i = 0; i < 4; i++) {
+		CHECK(on_bus(found[i]) >= 0);
+		CHECK_EQ(found[i][0], DS18B20_SIG);
+	}
+	memset(found, 0xEE, sizeof(found));
+	CHECK_EQ(OWSearchAll(found, 2), 2);
+	CHECK_EQ(found[2][0], 0xEE);	// nothing written past max
+	CHECK_EQ(ow_sim_violations, 0);
+
+	/* Empty bus: no presence pulse */
+	uint8_t rom[8];
+	ow_sim_clear();
+	CHECK_EQ(OWFirst(rom), OW_NOPRESENCE);
+	CHECK_EQ(OWSearchAll(found, OW_SIM_MAX), 0);
+	TEST_END();
+}
@@ -0,0 +1,309 @@
+/*
+ * ow_sim.c
+ *
+ * Each slave follows the DS18B20 state machine: ROM command after a reset
+ * (skip, match, read, search), then a function command (convert, read
+ * scratchpad). Slots are decoded from the master's low time at the rising
+ * edge; a slave sending 0 holds the line low for 30 us from the falling
+ * edge, so several slaves answering at once form the wired AND.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "main.h"
+#include "1wire.h"
+#include "ow_sim.h"
+
+#define T_RESET_MIN 480
+#define T_PRESENCE_START 30
+#define T_PRESENCE_END 150
+#define T_RSTH 480
+#define T_WRITE1_MAX 15
+#define T_WRITE0_MIN 60
+#define T_WRITE0_MAX 120
+#define T_SLOT_MIN 61	// 60 us slot + 1 us recovery
+#define T_RDV 15	// master must sample within this after the falling edge
+#define T_SLAVE_LOW 30
+#define T_CONV 750000
+
+enum {
+	SIM_IDLE,	// not addressed until the next reset
+	SIM_ROM_CMD,
+	SIM_MATCH,
+	SIM_READ_ROM,
+	SIM_SEARCH,
+	SIM_FUNC_CMD,
+	SIM_READ_SCR,
+	SIM_CONVERTING,
+};
+
+typedef struct {
+	uint8_t rom[8];
+	int16_t temp;
+	uint8_t scratch[9];
+	uint8_t state;
+	uint16_t bit;	// bit position within the current command phase
+	uint8_t rx;	// byte being received
+	uint8_t tx_bit;	// bit this slave drives in the current slot
+	uint8_t corrupt;	// armed by ow_sim_corrupt()
+	uint8_t corrupting;	// flipping a bit in the scratchpad being sent
+	uint32_t conv_end;	// 0 = no conversion running
+} sim_slave_t;
+
+static sim_slave_t slaves[OW_SIM_MAX];
+static uint8_t slave_cnt;
+static uint32_t now;
+static uint8_t master = 1;
+static uint32_t t_fall, t_rise, t_reset;
+static uint8_t slot_open;
+static uint8_t slot_seen;
+static uint32_t pull_until;	// slaves hold the line low until then
+static uint32_t presence_from, presence_to;
+
+uint32_t ow_sim_violations;
+uint32_t ow_sim_conversions;
+
+static void violation(const char *what, uint32_t t) {
+	printf("ow_sim: %s (%u us) at %u us\n", what, t, now);
+	ow_sim_violations++;
+}
+
+static uint8_t crc8(const uint8_t *buf, uint8_t len) {
+	uint8_t crc = 0;
+
+	for (uint8_t i = 0; i < len; i++) {
+		uint8_t x = buf[i];
+		for (uint8_t b = 0; b < 8; b++, x >>= 1) {
+			uint8_t mix = (crc ^ x) & 1;
+			crc >>= 1;
+			if (mix) crc ^= 0x8C;
+		}
+	}
+	return crc;
+}
+
+void ow_sim_rom_crc(uint8_t rom[8]) {
+	rom[7] = crc8(rom, 7);
+}
+
+static void scratch_update(sim_slave_t *s, int16_t temp) {
+	s->scratch[0] = temp & 0xFF;
+	s->scratch[1] = (uint16_t) temp >> 8;
+	s->scratch[2] = 0x4B;	// TH
+	s->scratch[3] = 0x46;	// TL
+	s->scratch[4] = 0x7F;	// 12 bit
+	s->scratch[5] = 0xFF;
+	s->scratch[6] = 0x0C;
+	s->scratch[7] = 0x10;
+	s->scratch[8] = crc8(s->scratch, 8);
+}
+
+void ow_sim_clear(void) {
+	memset(slaves, 0, sizeof(slaves));
+	slave_cnt = 0;
+	now = 1000;
+	master = 1;
+	t_fall = t_rise = t_reset = 0;
+	slot_open = slot_seen = 0;
+	pull_until = presence_from = presence_to = 0;
+	ow_sim_violations = 0;
+	ow_sim_conversions = 0;
+}
+
+void ow_sim_add(const uint8_t rom[8], int16_t temp) {
+	sim_slave_t *s = &slaves[slave_cnt++];
+
+	memcpy(s->rom, rom, 8);
+	s->temp = temp;
+	s->state = SIM_IDLE;
+	scratch_update(s, 0x0550);	// power-on 85 C
+}
+
+void ow_sim_corrupt(uint8_t n) {
+	slaves[n].corrupt = 1;
+}
+
+uint32_t ow_sim_now(void) {
+	return now;
+}
+
+/* What the slave drives in a slot starting now, 1 = released */
+static uint8_t slave_tx(sim_slave_t *s) {
+	switch (s->state) {
+	case SIM_READ_ROM:
+		return s->rom[s->bit >> 3] >> (s->bit & 7) & 1;
+	case SIM_SEARCH: {
+		uint8_t b = s->rom[(s->bit / 3) >> 3] >> ((s->bit / 3) & 7) & 1;
+		switch (s->bit % 3) {
+		case 0: return b;
+		case 1: return !b;
+		default: return 1;	// master writes the direction
+		}
+	}
+	case SIM_READ_SCR: {
+		uint8_t b = s->scratch[s->bit >> 3] >> (s->bit & 7) & 1;
+		if (s->corrupting && s->bit == 13) b ^= 1;
+		return b;
+	}
+	case SIM_CONVERTING:
+		return s->conv_end == 0;	// read slots answer 0 until done
+	default:
+		return 1;
+	}
+}
+
+static void slave_func(sim_slave_t *s, uint8_t cmd) {
+	s->bit = 0;
+	switch (cmd) {
+	case OW_CONVERT_T_CMD:
+		s->state = SIM_CONVERTING;
+		s->conv_end = now + T_CONV;
+		ow_sim_conversions++;
+		break;
+	case OW_RD_SCR_CMD:
+		s->state = SIM_READ_SCR;
+		s->corrupting = s->corrupt;
+		s->corrupt = 0;
+		break;
+	default:
+		s->state = SIM_IDLE;
+		break;
+	}
+}
+
+/* Master wrote bit b in the slot that just ended */
+static void slave_rx(sim_slave_t *s, uint8_t b) {
+	switch (s->state) {
+	case SIM_ROM_CMD:
+	case SIM_FUNC_CMD:
+		s->rx = s->rx >> 1 | b << 7;
+		if (++s->bit < 8) break;
+		if (s->state == SIM_FUNC_CMD) {
+			slave_func(s, s->rx);
+			break;
+		}
+		s->bit = 0;
+		switch (s->rx) {
+		case OW_SKIP_ROM_CMD: s->state = SIM_FUNC_CMD; break;
+		case OW_MATCH_ROM_CMD: s->state = SIM_MATCH; break;
+		case OW_READ_ROM_CMD: s->state = SIM_READ_ROM; break;
+		case OW_SEARCH_ROM_CMD: s->state = SIM_SEARCH; break;
+		default: s->state = SIM_IDLE; break;
+		}
+		break;
+	case SIM_MATCH:
+		if ((s->rom[s->bit >> 3] >> (s->bit & 7) & 1) != b) {
+			s->state = SIM_IDLE;
+		} else if (++s->bit == 64) {
+			s->state = SIM_FUNC_CMD;
+			s->bit = 0;
+		}
+		break;
+	case SIM_SEARCH:
+		if (s->bit % 3 == 2 && (s->rom[(s->bit / 3) >> 3] >> ((s->bit / 3) & 7) & 1) != b) {
+			s->state = SIM_IDLE;	// master took the other branch
+			break;
+		}
+		if (++s->bit == 3 * 64) s->state = SIM_FUNC_CMD, s->bit = 0;
+		break;
+	case SIM_READ_ROM:
+		if (++s->bit == 64) s->state = SIM_FUNC_CMD, s->bit = 0;
+		break;
+	case SIM_READ_SCR:
+		if (++s->bit == 72) s->state = SIM_IDLE, s->corrupting = 0;
+		break;
+	}
+}
+
+/* A conversion finishes on time whatever the master does meanwhile */
+static void slave_tick(sim_slave_t *s) {
+	if (s->conv_end && now >= s->conv_end) {
+		scratch_update(s, s->temp);
+		s->conv_end = 0;
+	}
+}
+
+void ow_sim_set(uint8_t level) {
+	level = level ? 1 : 0;
+	if (level == master) return;
+	master = level;
+
+	if (!level) {
+		/* falling edge: a slot starts, slaves decide what to send */
+		if (slot_seen && now - t_fall < T_SLOT_MIN)
+			violation("slot too short", now - t_fall);
+		if (now - t_rise < 1)
+			violation("no recovery", now - t_rise);
+		if (slave_cnt && t_reset && now < t_reset + T_RSTH)
+			violation("slot during presence", now - t_reset);
+		t_fall = now;
+		slot_open = 1;
+		slot_seen = 1;
+		pull_until = 0;
+		for (uint8_t i = 0; i < slave_cnt; i++) {
+			sim_slave_t *s = &slaves[i];
+			slave_tick(s);
+			s->tx_bit = slave_tx(s);
+			if (!s->tx_bit)
+				pull_until = now + T_SLAVE_LOW;
+		}
+		return;
+	}
+
+	/* rising edge: classify the low pulse */
+	uint32_t low = now - t_fall;
+	t_rise = now;
+	if (low >= T_RESET_MIN) {
+		t_reset = now;
+		slot_open = slot_seen = 0;
+		pull_until = 0;
+		if (slave_cnt) {
+			presence_from = now + T_PRESENCE_START;
+			presence_to = now + T_PRESENCE_END;
+		}
+		for (uint8_t i = 0; i < slave_cnt; i++) {
+			slave_tick(&slaves[i]);
+			slaves[i].state = SIM_ROM_CMD;
+			slaves[i].bit = 0;
+			slaves[i].corrupting = 0;
+		}
+		return;
+	}
+	if (low > T_WRITE1_MAX && low < T_WRITE0_MIN)
+		violation("ambiguous slot", low);
+	if (low > T_WRITE0_MAX)
+		violation("write 0 too long", low);
+	uint8_t b = low <= T_WRITE1_MAX;
+	for (uint8_t i = 0; i < slave_cnt; i++) {
+		sim_slave_t *s = &slaves[i];
+		if (s->state == SIM_CONVERTING) {
+			continue;
+		} else if (s->state == SIM_READ_ROM || s->state == SIM_READ_SCR
+				|| (s->state == SIM_SEARCH && s->bit % 3 != 2)) {
+			slave_rx(s, s->tx_bit);	// slave was sending
+		} else {
+			slave_rx(s, b);
+		}
+	}
+}
+
+uint8_t ow_sim_get(void) {
+	if (!master) return 0;
+	if (now >= presence_from && now < presence_to) return 0;
+	if (slot_open && now - t_fall > T_RDV)
+		violation("late sample", now - t_fall);
+	slot_open = 0;
+	return now >= pull_until;
+}
+
+void ow_sim_delay(uint32_t us) {
+	now += us;
+}
+
+void ow_sim_run_timer(void) {
+	while (OW_TIM->CR1 & TIM_CR1_CEN) {
+		now += OW_TIM->ARR + 1;	// one pulse from CNT = 0
+		OW_TIM->CR1 &= ~TIM_CR1_CEN;
+		OW_TIM->SR |= TIM_SR_UIF;
+		OWTimerIRQ();
+	}
+}
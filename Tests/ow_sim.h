@@ -0,0 +1,41 @@
+/*
+ * ow_sim.h
+ *
+ * Host 1-Wire bus with DS18B20 slaves, timed in microseconds. Cv_06
+ * 1wire.c is built with OW_PORT pointing here, so its pin writes, pin
+ * reads and busy-waits all land in the simulator. Slot timing that would
+ * not work on a real bus is counted in ow_sim_violations.
+ */
+
+#ifndef OW_SIM_H_
+#define OW_SIM_H_
+
+#include <stdint.h>
+
+#define OWInitHw()          { }
+#define OWSetLink(x)        ow_sim_set(x)
+#define OWGetLink()         ow_sim_get()
+#define _delay_us(us)       ow_sim_delay(us)
+
+#define OW_SIM_MAX 16
+
+void ow_sim_set(uint8_t level);
+uint8_t ow_sim_get(void);
+void ow_sim_delay(uint32_t us);
+
+/* Empties the bus, time restarts at 0 */
+void ow_sim_clear(void);
+/* Adds a slave; temp is the raw 1/16 C reading its next conversion gives */
+void ow_sim_add(const uint8_t rom[8], int16_t temp);
+/* Fills rom[7] with the Dallas CRC of rom[0..6] */
+void ow_sim_rom_crc(uint8_t rom[8]);
+/* Flips one bit in the next scratchpad slave n sends */
+void ow_sim_corrupt(uint8_t n);
+/* Runs OW_TIM interrupts until the one-pulse timer stays stopped */
+void ow_sim_run_timer(void);
+uint32_t ow_sim_now(void);
+
+extern uint32_t ow_sim_violations;
+extern uint32_t ow_sim_conversions;
+
+#endif /* OW_SIM_H_ */
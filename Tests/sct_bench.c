@@ -0,0 +1,79 @@
+/*
+ * sct_bench.c
+ *
+ * Main-loop display traffic through the cached sct_value() and through the
+ * original one (sct_ref.c). Both must latch the same frames; the report
+ * gives pin changes and host time per call. A HAL_GPIO_WritePin costs some
+ * 20-30 cycles on the F030, so the change count is the target-side figure.
+ */
+#include <stdint.h>
+#include <time.h>
+#include "main.h"
+#include "test.h"
+
+void gpio_sct_init(void);
+void gpio_sct_value(uint16_t value, uint16_t led);
+void ref_sct_value(uint16_t value, uint16_t led);
+
+#define CALLS 200000
+#define HOLD 500 // calls per displayed value, a few ms of main loop;
+
+static uint32_t sr, latched, writes;
+
+static void bus_hook(GPIO_TypeDef *port, uint32_t old) {
+	uint32_t rise = port->ODR & ~old;
+
+	writes++;
+	if (rise & SCT_CLK_Pin)
+		sr = (sr >> 1) | ((port->ODR & SCT_SDI_Pin) ? 1UL << 31 : 0);
+	if (rise & SCT_NLA_Pin)
+		latched = sr;
+}
+
+static uint64_t now_ns(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void bench(const char *name, void (*value)(uint16_t, uint16_t)) {
+	uint32_t updates = 0;
+
+	writes = 0;
+	uint64_t t0 = now_ns();
+	for (uint32_t i = 0; i < CALLS; i++) {
+		uint16_t v = i / HOLD * 7 % 1000;
+		value(v, v / 112);
+		updates += i % HOLD == 0;
+	}
+	uint64_t t = now_ns() - t0;
+	printf("%-8s %u calls, %u updates: %.1f pin changes/call, %.1f ns/call, %.0f pin changes/update\n",
+			name, CALLS, updates, (double) writes / CALLS, (double) t / CALLS,
+			(double) writes / updates);
+}
+
+int main(void) {
+	mock_gpio_hook = bus_hook;
+	gpio_sct_init();
+
+	/* Same frame for every value and bar length */
+	for (uint16_t v = 0; v < 1000; v++) {
+		for (uint16_t led = 0; led <= 8; led++) {
+			ref_sct_value(v, led);
+			uint32_t ref = latched;
+			latched = ~ref;
+			gpio_sct_value(v, led);
+			if (latched != ref) {
+				printf("value %u led %u: ref %08x, cached %08x\n", v, led, ref, latched);
+				test_failures++;
+			}
+		}
+	}
+
+	bench("original", ref_sct_value);
+	uint32_t ref_writes = writes;
+	bench("cached", gpio_sct_value);
+	CHECK(writes * 100 < ref_writes); // repeats must not reach the bus;
+	TEST_END();
+}
@@ -0,0 +1,145 @@
+/*
+ * sct_test.c
+ *
+ * Drives the DMA and the bit-bang back-end of Cv_04 sct.c with the same
+ * calls and checks both latch the same frames into a model of the shift
+ * register chain on SDI/CLK/NLA.
+ */
+#include <stdint.h>
+#include <string.h>
+#include "main.h"
+#include "test.h"
+
+#define DECLARE_SCT(p) \
+	void p##sct_init(void); \
+	void p##sct_led(uint32_t led); \
+	void p##sct_value(uint16_t value, uint16_t led); \
+	uint32_t p##sct_format_dec(int16_t value, uint8_t dp); \
+	uint32_t p##sct_format_hex(uint16_t value); \
+	void p##sct_show(uint32_t frame, uint16_t led);
+DECLARE_SCT(gpio_)
+DECLARE_SCT(dma_)
+void dma_sct_dma_irq(void);
+
+typedef struct {
+	void (*init)(void);
+	void (*led)(uint32_t);
+	void (*value)(uint16_t, uint16_t);
+	uint32_t (*format_dec)(int16_t, uint8_t);
+	uint32_t (*format_hex)(uint16_t);
+	void (*show)(uint32_t, uint16_t);
+	void (*finish)(void);
+} sct_api_t;
+
+#define MAX_FRAMES 256
+
+static uint32_t sr;
+static uint32_t frames[MAX_FRAMES];
+static uint32_t frame_cnt;
+
+/* 74HC595 chain: shift on CLK rising edge, copy to the outputs on NLA rising */
+static void bus_hook(GPIO_TypeDef *port, uint32_t old) {
+	uint32_t rise = port->ODR & ~old;
+
+	if (port != SCT_CLK_GPIO_Port)
+		return;
+	if (rise & SCT_CLK_Pin)
+		sr = (sr >> 1) | ((port->ODR & SCT_SDI_Pin) ? 1UL << 31 : 0);
+	if ((rise & SCT_NLA_Pin) && frame_cnt < MAX_FRAMES)
+		frames[frame_cnt++] = sr;
+}
+
+static void gpio_finish(void) {
+}
+
+/* Plays the armed transfer into BSRR the way TIM16 + DMA1 channel 3 would */
+static void dma_finish(void) {
+	if (!(DMA1_Channel3->CCR & DMA_CCR_EN) || !(TIM16->CR1 & TIM_CR1_CEN))
+		return;
+	CHECK_EQ(DMA1_Channel3->CPAR, (uint32_t) (uintptr_t) &SCT_CLK_GPIO_Port->BSRR);
+	const uint32_t *src = (const uint32_t *) (uintptr_t) DMA1_Channel3->CMAR;
+	for (uint32_t i = 0; i < DMA1_Channel3->CNDTR; i++)
+		mock_gpio_bsrr(SCT_CLK_GPIO_Port, src[i]);
+	DMA1->ISR |= DMA_ISR_TCIF3;
+	dma_sct_dma_irq();
+	DMA1->ISR = 0;
+	CHECK(!(DMA1_Channel3->CCR & DMA_CCR_EN));
+}
+
+static const sct_api_t gpio_api = {
+	gpio_sct_init, gpio_sct_led, gpio_sct_value, gpio_sct_format_dec,
+	gpio_sct_format_hex, gpio_sct_show, gpio_finish,
+};
+static const sct_api_t dma_api = {
+	dma_sct_init, dma_sct_led, dma_sct_value, dma_sct_format_dec,
+	dma_sct_format_hex, dma_sct_show, dma_finish,
+};
+
+static const uint32_t raw[] = {
+	0, 0xFFFFFFFF, 0x80000001, 0xA5A55A5A, 0x12345678, 0x00010000,
+};
+
+/* One session of display traffic, frames land in frames[] */
+static uint32_t run(const sct_api_t *api) {
+	memset(&mock_gpiob, 0, sizeof(mock_gpiob));
+	memset(&mock_dma1_channel3, 0, sizeof(mock_dma1_channel3));
+	memset(&mock_tim16, 0, sizeof(mock_tim16));
+	sr = 0;
+	frame_cnt = 0;
+	mock_gpio_hook = bus_hook;
+
+	api->init();
+	api->finish();
+	for (uint32_t i = 0; i < sizeof(raw) / sizeof(raw[0]); i++) {
+		uint32_t before = frame_cnt;
+		api->led(raw[i]);
+		api->finish();
+		CHECK_EQ(frame_cnt, before + 1);
+		CHECK_EQ(frames[frame_cnt - 1], raw[i]);
+	}
+	for (uint16_t v = 0; v < 1000; v += 37) {
+		api->value(v, v % 9);
+		api->finish();
+		api->value(v, v % 9); // unchanged, must not reach the bus;
+		api->finish();
+	}
+	for (int16_t v = -120; v <= 1000; v += 53) {
+		for (uint8_t dp = 0; dp <= 3; dp++) {
+			api->show(api->format_dec(v, dp), dp);
+			api->finish();
+		}
+	}
+	for (uint16_t v = 0; v < 0x1000; v += 0x135) {
+		api->show(api->format_hex(v), 8);
+		api->finish();
+	}
+	api->led(0x5A5A5A5A); // raw write in between drops the cache;
+	api->finish();
+	api->value(999, 8);
+	api->finish();
+	api->value(999, 8);
+	api->finish();
+	mock_gpio_hook = NULL;
+	return frame_cnt;
+}
+
+int main(void) {
+	static uint32_t gpio_frames[MAX_FRAMES];
+
+	uint32_t gpio_cnt = run(&gpio_api);
+	memcpy(gpio_frames, frames, sizeof(frames));
+	uint32_t dma_cnt = run(&dma_api);
+
+	CHECK(gpio_cnt > 40);
+	CHECK(gpio_cnt < MAX_FRAMES);
+	CHECK_EQ(dma_cnt, gpio_cnt);
+	for (uint32_t i = 0; i < gpio_cnt && i < dma_cnt; i++) {
+		if (gpio_frames[i] != frames[i]) {
+			printf("frame %u: gpio %08x, dma %08x\n", i, gpio_frames[i], frames[i]);
+			test_failures++;
+		}
+	}
+	/* Both leave the bus idle: CLK and NLA low */
+	CHECK_EQ(mock_gpiob.ODR & (SCT_CLK_Pin | SCT_NLA_Pin), 0);
+	TEST_END();
+}
@@ -0,0 +1,244 @@
+/*
+ * telnet_test.c
+ *
+ * Cv_12 telnet.c over the loopback netconn layer: replies and segments
+ * per command, the session limit, the idle timeout, and many clients at
+ * once sending their lines in random fragments.
+ */
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "lwip/sys.h"
+#include "net_sim.h"
+#include "tcpecho.h"
+#include "ethernetif_stats.h"
+#include "test.h"
+
+#define TIMEOUT_MS 2000
+#define LOAD_CLIENTS 16
+#define LOAD_COMMANDS 300
+
+void telnet_init(void);
+
+void tcpecho_stats(tcpecho_stats_t *total, tcpecho_stats_t *per_s) {
+	memset(total, 0, sizeof(*total));
+	memset(per_s, 0, sizeof(*per_s));
+}
+
+void ethernetif_rx_stats(ethernetif_rx_stats_t *st) {
+	memset(st, 0, sizeof(*st));
+}
+
+void Error_Handler(void) {
+	abort();
+}
+
+/* Next connection the server takes, NULL if it turned it away */
+static struct netconn *connect_session(void) {
+	static const char busy[] = "Too many sessions\r\n";
+	char buf[sizeof(busy)];
+	struct netconn *c;
+
+	while ((c = net_sim_connect(23)) == NULL)
+		usleep(1000); // listener not up yet;
+	/* a refused client gets the notice at once, give it a moment */
+	if (net_sim_closed(c, 20)) {
+		size_t n = net_sim_read(c, buf, sizeof(buf) - 1, 0);
+		buf[n] = 0;
+		if (strcmp(buf, busy))
+			printf("unexpected refusal: '%s'\n", buf);
+		return NULL;
+	}
+	return c;
+}
+
+/* Sends line, checks the whole reply and returns what it cost */
+static uint8_t command(struct netconn *c, const char *line, const char *reply, net_sim_tx_t *cost) {
+	size_t len = strlen(reply);
+	char buf[512];
+	net_sim_tx_t before, after;
+
+	net_sim_tx(c, &before);
+	net_sim_send(c, line, strlen(line));
+	if (net_sim_read(c, buf, len, TIMEOUT_MS) != len || memcmp(buf, reply, len)) {
+		printf("'%s' got the wrong reply\n", line);
+		return 0;
+	}
+	net_sim_tx(c, &after);
+	if (cost != NULL) {
+		cost->writes = after.writes - before.writes;
+		cost->segments = after.segments - before.segments;
+		cost->bytes = after.bytes - before.bytes;
+	}
+	return 1;
+}
+
+static void test_replies(void) {
+	static const struct {
+		const char *line;
+		const char *reply;
+	} cases[] = {
+		{ "HELLO\r\n", "Komunikace OK\r\n" },
+		{ "LED1 ON\r\n", "OK\r\n" },
+		{ "LED3 OFF\n", "OK\r\n" },
+		{ "STATUS\r\n", "STATE: \r\nLED1=ON\r\nLED2=OFF\r\nLED3=OFF\r\n" },
+		{ "CLIENT\r\n", "Chyba pripojeni\r\n" },
+		{ "NOPE\r\nhello\r\n", "Komunikace OK\r\n" }, // nothing for an unknown command;
+	};
+	struct netconn *c = connect_session();
+	net_sim_tx_t cost;
+
+	CHECK(c != NULL);
+	if (c == NULL) return;
+	for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+		CHECK(command(c, cases[i].line, cases[i].reply, &cost));
+		printf("telnet %-8.*s %u B in %u write(s), %u segment(s)\n",
+				(int) strcspn(cases[i].line, "\r\n"), cases[i].line,
+				(unsigned) cost.bytes, (unsigned) cost.writes, (unsigned) cost.segments);
+		CHECK_EQ(cost.writes, 1);
+		CHECK_EQ(cost.segments, 1);
+	}
+	net_sim_hangup(c);
+	CHECK(net_sim_closed(c, TIMEOUT_MS));
+}
+
+/* One session per worker, the next client is turned away */
+static void test_limit(void) {
+	struct netconn *c[TELNET_MAX_SESSIONS];
+
+	for (int i = 0; i < TELNET_MAX_SESSIONS; i++) {
+		c[i] = connect_session();
+		CHECK(c[i] != NULL);
+	}
+	CHECK(connect_session() == NULL);
+	for (int i = 0; i < TELNET_MAX_SESSIONS; i++)
+		if (c[i] != NULL) {
+			CHECK(command(c[i], "HELLO\r\n", "Komunikace OK\r\n", NULL));
+			net_sim_hangup(c[i]);
+			CHECK(net_sim_closed(c[i], TIMEOUT_MS));
+		}
+}
+
+/* Quiet sessions are dropped and their slots serve new clients, a
+ * session that keeps talking stays */
+static void test_timeout(void) {
+	struct netconn *idle[TELNET_MAX_SESSIONS - 1], *busy, *c;
+	u32_t start = sys_now();
+
+	busy = connect_session();
+	for (int i = 0; i < TELNET_MAX_SESSIONS - 1; i++)
+		idle[i] = connect_session();
+	CHECK(connect_session() == NULL);
+
+	while (sys_now() - start < 3 * TELNET_IDLE_TIMEOUT) {
+		CHECK(command(busy, "HELLO\r\n", "Komunikace OK\r\n", NULL));
+		usleep(TELNET_IDLE_TIMEOUT * 1000 / 4);
+	}
+	for (int i = 0; i < TELNET_MAX_SESSIONS - 1; i++)
+		CHECK(idle[i] != NULL && net_sim_closed(idle[i], TIMEOUT_MS));
+	CHECK(!net_sim_closed(busy, 0));
+
+	c = connect_session();
+	CHECK(c != NULL);
+	if (c != NULL) {
+		CHECK(command(c, "LED2 ON\r\n", "OK\r\n", NULL));
+		net_sim_hangup(c);
+	}
+	net_sim_hangup(busy);
+	CHECK(net_sim_closed(busy, TIMEOUT_MS));
+}
+
+typedef struct {
+	unsigned seed;
+	unsigned done;
+	unsigned refused;
+	unsigned wrong;
+} load_t;
+
+/* Sends line in random fragments */
+static void send_fragments(struct netconn *c, const char *line, unsigned *seed) {
+	size_t len = strlen(line), pos = 0;
+
+	while (pos < len) {
+		size_t n = 1 + rand_r(seed) % 4;
+		if (n > len - pos)
+			n = len - pos;
+		net_sim_send(c, line + pos, n);
+		pos += n;
+		if (rand_r(seed) % 8 == 0)
+			sched_yield();
+	}
+}
+
+static void *load_client(void *arg) {
+	static const struct {
+		const char *line;
+		const char *reply;
+	} mix[] = {
+		{ "HELLO\r\n", "Komunikace OK\r\n" },
+		{ "LED2 ON\r\n", "OK\r\n" },
+		{ "LED2 OFF\r\n", "OK\r\n" },
+		{ "CLIENT\r\n", "Chyba pripojeni\r\n" },
+	};
+	load_t *l = arg;
+	struct netconn *c = NULL;
+	char buf[64];
+
+	while (l->done < LOAD_COMMANDS) {
+		unsigned k = rand_r(&l->seed) % 4;
+		size_t len = strlen(mix[k].reply);
+
+		if (c == NULL && (c = connect_session()) == NULL) {
+			l->refused++;
+			usleep(1000);
+			continue;
+		}
+		send_fragments(c, mix[k].line, &l->seed);
+		if (net_sim_read(c, buf, len, TIMEOUT_MS) != len || memcmp(buf, mix[k].reply, len))
+			l->wrong++;
+		l->done++;
+		/* now and then give the slot to someone else */
+		if (rand_r(&l->seed) % 50 == 0) {
+			net_sim_hangup(c);
+			c = NULL;
+		}
+	}
+	if (c != NULL)
+		net_sim_hangup(c);
+	return NULL;
+}
+
+static void test_load(void) {
+	pthread_t t[LOAD_CLIENTS];
+	load_t l[LOAD_CLIENTS];
+	unsigned done = 0, refused = 0, wrong = 0;
+	u32_t start = sys_now(), ms;
+
+	for (int i = 0; i < LOAD_CLIENTS; i++) {
+		memset(&l[i], 0, sizeof(l[i]));
+		l[i].seed = 1234 + i;
+		pthread_create(&t[i], NULL, load_client, &l[i]);
+	}
+	for (int i = 0; i < LOAD_CLIENTS; i++) {
+		pthread_join(t[i], NULL);
+		done += l[i].done;
+		refused += l[i].refused;
+		wrong += l[i].wrong;
+	}
+	ms = sys_now() - start;
+	printf("telnet load: %d clients, %u commands in %u ms, %u refused connects\n",
+			LOAD_CLIENTS, done, (unsigned) ms, refused);
+	CHECK_EQ(done, LOAD_CLIENTS * LOAD_COMMANDS);
+	CHECK_EQ(wrong, 0);
+	CHECK(refused > 0); // more clients than sessions, some had to wait;
+}
+
+int main(void) {
+	telnet_init();
+	test_replies();
+	test_limit();
+	test_timeout();
+	test_load();
+	TEST_END();
+}
@@ -0,0 +1,35 @@
+/*
+ * test.h
+ *
+ * Minimal check macros for the host tests: a failed CHECK prints where
+ * and carries on, TEST_END turns the count into the exit code.
+ */
+
+#ifndef TEST_H_
+#define TEST_H_
+
+#include <stdio.h>
+
+static int test_failures;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+		test_failures++; \
+	} \
+} while (0)
+
+#define CHECK_EQ(a, b) do { \
+	long long a_ = (long long)(a), b_ = (long long)(b); \
+	if (a_ != b_) { \
+		printf("%s:%d: %s == %s failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, a_, b_); \
+		test_failures++; \
+	} \
+} while (0)
+
+#define TEST_END() do { \
+	printf("%s: %s\n", __FILE__, test_failures ? "FAILED" : "ok"); \
+	return test_failures ? 1 : 0; \
+} while (0)
+
+#endif /* TEST_H_ */
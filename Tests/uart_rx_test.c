@@ -0,0 +1,146 @@
+/*
+ * uart_rx_test.c
+ *
+ * Cv_05 uart_rx.c fed through a model of the circular receive DMA: bytes
+ * land at the DMA position, HT/TC/IDLE events publish it, and the main
+ * loop polls at random points. Every line sent must come out once and
+ * intact wherever the buffer wrap falls inside it.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "main.h"
+#include "uart_rx.h"
+#include "test.h"
+
+#define MAX_LINES 4096
+
+static char expect[MAX_LINES][UART_RX_LINE_LEN + 1];
+static uint32_t expect_cnt, got_cnt;
+static char model[UART_RX_LINE_LEN + 1];
+static uint16_t model_len;
+
+static uint16_t dma_pos;	// next byte the DMA writes
+static uint16_t unread;	// written since the last poll that drained everything
+
+static void on_line(char *line) {
+	if (got_cnt >= expect_cnt || strcmp(line, expect[got_cnt]) != 0) {
+		printf("line %u: got \"%.40s\", want \"%.40s\"\n", got_cnt, line,
+				got_cnt < expect_cnt ? expect[got_cnt] : "(none)");
+		test_failures++;
+	}
+	got_cnt++;
+}
+
+static void reset(void) {
+	uart_rx_init(on_line);
+	dma_pos = 0;
+	unread = 0;
+	expect_cnt = got_cnt = 0;
+	model_len = 0;
+}
+
+static void poll(void) {
+	uart_rx_event(dma_pos);	// IDLE
+	uart_rx_poll();
+	unread = 0;
+}
+
+/* One byte through the DMA, with the HT/TC events the hardware raises */
+static void rx_byte(uint8_t c) {
+	if (unread == UART_RX_BUF_LEN - 1)
+		poll();	// the main loop has to keep up, as on the target
+	uart_rx_buf[dma_pos] = c;
+	dma_pos = (dma_pos + 1) % UART_RX_BUF_LEN;
+	unread++;
+	if (dma_pos == UART_RX_BUF_LEN / 2)
+		uart_rx_event(UART_RX_BUF_LEN / 2);
+	else if (dma_pos == 0)
+		uart_rx_event(UART_RX_BUF_LEN);
+
+	/* what uart_rx should hand over */
+	if (model_len < UART_RX_LINE_LEN && c >= ' ' && c <= '~')
+		model[model_len++] = c;
+	if ((c == '\n' || c == '\r') && model_len > 0) {
+		model[model_len] = '\0';
+		if (expect_cnt < MAX_LINES)
+			strcpy(expect[expect_cnt++], model);
+		model_len = 0;
+	}
+}
+
+static void rx_str(const char *s) {
+	while (*s)
+		rx_byte(*s++);
+}
+
+static void finish(void) {
+	poll();
+	CHECK_EQ(got_cnt, expect_cnt);
+	CHECK(uart_rx_poll());
+}
+
+int main(void) {
+	char line[300];
+
+	/* A 100 byte line starting at every buffer position, delivered in
+	 * bursts of several sizes */
+	static const uint16_t bursts[] = { 1, 7, 31, 32, 33, 63 };
+	for (uint16_t start = 0; start < UART_RX_BUF_LEN; start++) {
+		for (uint8_t b = 0; b < sizeof(bursts) / sizeof(bursts[0]); b++) {
+			reset();
+			memset(line, 'a', start);
+			line[start] = '\0';
+			rx_str(line);
+			rx_str("\n");
+			poll();
+			for (uint16_t i = 0; i < 100; i++) {
+				rx_byte('0' + (i + start) % 75);
+				if (i % bursts[b] == bursts[b] - 1)
+					poll();
+			}
+			rx_str("\r\n");
+			finish();
+		}
+	}
+
+	/* Random traffic: printable runs, CR/LF/CRLF, control bytes, lines
+	 * longer than UART_RX_LINE_LEN, polls at random points */
+	srand(12);
+	reset();
+	for (uint32_t i = 0; i < 200000 && expect_cnt < MAX_LINES - 1; i++) {
+		int r = rand() % 100;
+		if (r < 80)
+			rx_byte(' ' + rand() % 95);
+		else if (r < 86)
+			rx_byte("\r\n"[rand() % 2]);
+		else if (r < 88)
+			rx_byte(rand() % 32);
+		else if (r < 89)
+			for (int j = rand() % 400; j; j--) rx_byte('#');
+		if (rand() % 17 == 0)
+			poll();
+	}
+	CHECK(expect_cnt > 1000);
+	finish();
+
+	/* An overrun restarts the DMA at 0: the partial line is dropped, the
+	 * next one arrives whole even though read_ptr was elsewhere */
+	reset();
+	rx_str("GET 1\nSET 2 A");
+	poll();
+	rx_str("BC");
+	uart_rx_restart();
+	dma_pos = 0;
+	unread = 0;
+	model_len = 0;
+	rx_str("HELLO\n");
+	finish();
+	CHECK_EQ(got_cnt, 2);
+
+	/* A restart with nothing new yet leaves the loop idle */
+	uart_rx_restart();
+	dma_pos = 0;
+	CHECK(uart_rx_poll());
+	TEST_END();
+}
@@ -0,0 +1,144 @@
+/* Generated by filter_vectors.py, do not edit */
+#define VEC_N 384
+#define VEC_CH 2
+#define VEC_EMA_SHIFT 4
+#define VEC_MA_LEN 8
+#define VEC_MEDIAN_LEN 5
+#define VEC_CIC_LOG2 2
+#define VEC_INIT 295
+static const uint16_t vec_adc[768] = {
+	295, 1849, 300, 1851, 321, 1847, 317, 1846, 324, 1851, 350, 1849, 366, 1845, 358, 1853,
+	377, 1850, 377, 1847, 381, 1849, 393, 1845, 416, 1849, 413, 1848, 419, 1849, 432, 1855,
+	455, 1850, 1343, 1854, 460, 1855, 471, 1853, 475, 1847, 484, 1852, 494, 1846, 512, 1849,
+	504, 1849, 531, 1849, 546, 1853, 537, 1851, 553, 1854, 558, 1851, 572, 1847, 574, 1849,
+	584, 1845, 587, 1845, 608, 1855, 611, 1853, 629, 1855, 636, 1850, 634, 1855, 645, 1846,
+	661, 1848, 677, 1855, 680, 1849, 680, 1850, 697, 1854, 703, 1855, 719, 1848, 721, 1846,
+	721, 1848, 737, 1854, 757, 1848, 750, 1850, 761, 1849, 779, 1845, 775, 1850, 805, 1846,
+	801, 1855, 811, 1845, 820, 1849, 829, 1847, 852, 1855, 850, 1854, 867, 1846, 864, 1854,
+	870, 1852, 882, 1847, 890, 1851, 910, 1847, 910, 1854, 909, 1850, 1819, 1852, 932, 1850,
+	947, 1849, 963, 1846, 968, 1848, 976, 1848, 975, 1845, 982, 1845, 1013, 1847, 1018, 1855,
+	1012, 1854, 1018, 1853, 1041, 1854, 1042, 1850, 1045, 1846, 1069, 1849, 1086, 1851, 1091, 1848,
+	1095, 1848, 1096, 1852, 1111, 1852, 1108, 1848, 1129, 1852, 1132, 1855, 1147, 1848, 1158, 1848,
+	1153, 1845, 1169, 1849, 1177, 1853, 1185, 1848, 1201, 1849, 1201, 1850, 1207, 1850, 1233, 1846,
+	1242, 1851, 1253, 1855, 1264, 1845, 1266, 1851, 1262, 1851, 1275, 1854, 1283, 1850, 1296, 1855,
+	1311, 1855, 1315, 1851, 1330, 1848, 1343, 1855, 1340, 1850, 1353, 1852, 1352, 1849, 1379, 1855,
+	1374, 1845, 1389, 1854, 1390, 1849, 2316, 1845, 1409, 1855, 1427, 1854, 1437, 1851, 1443, 1848,
+	1440, 1848, 1454, 1845, 1477, 1849, 1470, 1851, 1500, 1851, 1492, 1853, 1495, 1848, 1508, 1855,
+	1531, 1850, 1538, 1852, 1546, 1852, 1539, 1846, 1549, 1854, 1560, 1852, 1583, 1849, 1594, 1847,
+	1585, 1850, 1595, 1853, 1602, 1849, 1622, 1846, 1622, 1853, 1643, 1851, 1644, 1849, 1659, 1848,
+	1680, 1852, 1677, 1846, 1676, 1846, 1702, 1850, 1708, 1851, 1714, 1852, 1712, 1855, 1725, 1855,
+	1737, 1852, 1750, 1846, 1763, 1847, 1766, 1847, 1769, 1847, 1783, 1852, 1792, 1849, 1808, 1845,
+	1822, 1847, 1809, 1855, 1827, 1846, 1844, 1846, 1851, 1854, 1860, 1853, 1856, 1853, 1870, 1851,
+	2781, 1850, 1888, 1847, 1910, 1845, 1920, 1845, 1927, 1850, 1934, 1852, 1944, 1849, 1951, 1852,
+	1963, 1854, 1967, 1851, 1966, 1849, 1995, 1854, 1991, 1855, 1999, 1847, 2011, 1846, 2026, 1847,
+	2037, 1854, 2030, 1849, 2045, 1848, 2061, 1850, 2073, 1854, 2063, 1846, 2082, 1855, 2084, 1850,
+	2108, 1850, 2107, 1847, 2115, 1845, 2134, 1845, 2140, 1846, 2144, 1846, 2147, 1847, 2169, 1852,
+	2181, 1854, 2171, 1846, 2183, 1855, 2202, 1855, 2219, 1848, 2224, 1855, 2223, 1851, 2242, 1848,
+	2247, 1848, 2250, 1850, 2257, 1850, 2276, 1855, 2284, 1852, 2289, 1853, 2298, 1850, 2304, 1852,
+	2317, 1854, 2313, 1849, 2327, 1853, 2345, 1853, 2359, 1850, 3261, 1851, 2377, 1845, 2371, 1853,
+	2378, 1852, 2405, 1850, 2413, 1849, 2405, 1849, 2427, 1848, 2441, 1852, 2449, 1846, 2443, 1848,
+	2450, 1849, 2461, 1845, 2471, 1851, 2493, 1855, 2503, 1853, 2515, 1853, 2510, 1845, 2527, 1848,
+	2525, 1846, 2535, 1845, 2548, 1846, 2550, 1849, 2557, 1855, 2574, 1854, 2594, 1847, 2606, 1847,
+	2608, 1851, 2592, 1846, 2605, 1850, 2610, 1845, 2611, 1853, 2592, 1853, 2601, 1847, 2594, 1849,
+	2603, 1853, 2590, 1851, 2593, 1847, 2596, 1853, 2600, 1853, 2609, 1849, 2600, 1850, 2593, 1851,
+	2589, 1851, 2588, 1849, 2609, 1845, 2597, 1847, 2590, 1847, 2591, 1854, 2588, 1848, 2595, 1853,
+	2588, 1852, 2610, 1853, 3493, 1852, 2611, 1855, 2610, 1851, 2598, 1847, 2604, 1854, 2594, 1846,
+	2603, 1854, 2599, 1849, 2608, 1851, 2607, 1845, 2608, 1848, 2596, 1854, 2609, 1854, 2597, 1852,
+	2608, 1850, 2590, 1848, 2598, 1846, 2609, 1845, 2607, 1850, 2604, 1852, 2599, 1846, 2593, 1845,
+	2603, 1853, 2605, 1854, 2610, 1848, 2589, 1848, 2609, 1846, 2598, 1854, 2592, 1849, 2591, 1853,
+	2604, 1845, 2590, 1848, 2607, 1849, 2607, 1845, 2611, 1845, 2588, 1852, 2610, 1847, 2594, 1850,
+	2595, 1850, 2597, 1851, 2608, 1854, 2600, 1845, 2593, 1851, 2603, 1846, 2612, 1853, 2604, 1849,
+	2605, 1849, 2594, 1851, 2598, 1847, 2594, 1845, 2603, 1851, 2596, 1850, 2612, 1851, 3508, 1851,
+	2598, 1854, 2594, 1849, 2596, 1853, 2590, 1845, 2600, 1849, 2607, 1849, 2609, 1855, 2592, 1854,
+	2612, 1850, 2590, 1847, 2607, 1846, 2610, 1848, 2596, 1855, 2594, 1855, 2603, 1846, 2608, 1850,
+	2588, 1852, 2606, 1848, 2593, 1846, 2595, 1853, 2591, 1846, 2598, 1849, 2606, 1854, 2609, 1847,
+	2611, 1846, 2609, 1847, 2610, 1845, 2612, 1847, 2609, 1848, 2596, 1845, 2606, 1850, 2608, 1850,
+	2611, 1854, 2599, 1847, 2593, 1848, 2589, 1845, 2593, 1855, 2589, 1855, 2596, 1855, 2609, 1852,
+	2591, 1848, 2592, 1851, 2603, 1854, 2605, 1852, 2605, 1850, 2599, 1851, 2611, 1851, 2589, 1845,
+};
+static const uint16_t vec_ema[384] = {
+	295, 295, 296, 298, 299, 303, 307, 310, 314, 318, 322, 326, 332, 337, 342, 348,
+	354, 416, 419, 422, 425, 429, 433, 438, 442, 448, 454, 459, 465, 471, 477, 483,
+	490, 496, 503, 509, 517, 524, 531, 538, 546, 554, 562, 569, 577, 585, 594, 602,
+	609, 617, 626, 634, 641, 650, 658, 667, 675, 684, 692, 701, 710, 719, 728, 737,
+	745, 754, 762, 772, 780, 788, 853, 858, 863, 869, 876, 882, 888, 894, 901, 908,
+	915, 921, 929, 936, 943, 951, 959, 967, 975, 983, 991, 998, 1006, 1014, 1022, 1031,
+	1039, 1047, 1055, 1063, 1072, 1080, 1088, 1097, 1106, 1115, 1124, 1133, 1141, 1150, 1158, 1166,
+	1176, 1184, 1193, 1203, 1211, 1220, 1228, 1238, 1246, 1255, 1264, 1329, 1334, 1340, 1346, 1352,
+	1358, 1364, 1371, 1377, 1385, 1392, 1398, 1405, 1413, 1421, 1428, 1435, 1442, 1450, 1458, 1467,
+	1474, 1482, 1489, 1497, 1505, 1514, 1522, 1530, 1540, 1548, 1556, 1566, 1574, 1583, 1591, 1600,
+	1608, 1617, 1626, 1635, 1643, 1652, 1661, 1670, 1679, 1688, 1696, 1706, 1715, 1724, 1732, 1741,
+	1806, 1811, 1817, 1823, 1830, 1836, 1843, 1850, 1857, 1864, 1870, 1878, 1885, 1892, 1900, 1907,
+	1916, 1923, 1930, 1938, 1947, 1954, 1962, 1970, 1978, 1986, 1995, 2003, 2012, 2020, 2028, 2037,
+	2046, 2054, 2062, 2070, 2080, 2089, 2097, 2106, 2115, 2123, 2132, 2141, 2150, 2158, 2167, 2176,
+	2185, 2193, 2201, 2210, 2219, 2284, 2290, 2295, 2300, 2307, 2314, 2319, 2326, 2333, 2340, 2347,
+	2353, 2360, 2367, 2375, 2383, 2391, 2399, 2407, 2414, 2422, 2429, 2437, 2444, 2453, 2461, 2470,
+	2479, 2486, 2494, 2501, 2508, 2513, 2518, 2523, 2528, 2532, 2536, 2540, 2543, 2548, 2551, 2553,
+	2556, 2558, 2561, 2563, 2565, 2566, 2568, 2569, 2571, 2573, 2631, 2629, 2628, 2626, 2625, 2623,
+	2622, 2620, 2620, 2619, 2618, 2617, 2616, 2615, 2615, 2613, 2612, 2612, 2612, 2611, 2610, 2609,
+	2609, 2609, 2609, 2607, 2608, 2607, 2606, 2605, 2605, 2604, 2604, 2604, 2605, 2604, 2604, 2604,
+	2603, 2603, 2603, 2603, 2602, 2602, 2603, 2603, 2603, 2602, 2602, 2602, 2602, 2601, 2602, 2659,
+	2655, 2651, 2648, 2644, 2641, 2639, 2637, 2634, 2633, 2630, 2629, 2628, 2626, 2624, 2622, 2622,
+	2619, 2619, 2617, 2616, 2614, 2613, 2613, 2612, 2612, 2612, 2612, 2612, 2612, 2611, 2610, 2610,
+	2610, 2610, 2609, 2607, 2607, 2605, 2605, 2605, 2604, 2603, 2603, 2604, 2604, 2603, 2604, 2603,
+};
+static const uint16_t vec_ma[384] = {
+	295, 295, 298, 301, 305, 312, 321, 328, 339, 348, 356, 365, 377, 385, 391, 401,
+	410, 531, 541, 551, 558, 567, 576, 586, 592, 491, 502, 510, 520, 529, 539, 546,
+	556, 563, 571, 580, 590, 600, 607, 616, 626, 637, 646, 655, 663, 672, 682, 692,
+	699, 707, 716, 725, 733, 743, 750, 760, 770, 779, 787, 797, 809, 817, 829, 836,
+	845, 854, 863, 873, 880, 887, 1006, 1015, 1024, 1035, 1044, 1053, 1061, 1070, 969, 980,
+	988, 995, 1004, 1012, 1021, 1032, 1041, 1050, 1060, 1070, 1079, 1087, 1098, 1106, 1113, 1122,
+	1129, 1138, 1146, 1156, 1165, 1173, 1181, 1190, 1201, 1212, 1223, 1233, 1241, 1250, 1259, 1267,
+	1276, 1284, 1292, 1301, 1311, 1321, 1330, 1340, 1348, 1357, 1365, 1486, 1495, 1504, 1515, 1523,
+	1531, 1539, 1550, 1444, 1456, 1464, 1471, 1479, 1490, 1501, 1510, 1518, 1524, 1533, 1544, 1555,
+	1561, 1568, 1575, 1586, 1595, 1605, 1613, 1621, 1633, 1643, 1652, 1662, 1673, 1682, 1691, 1699,
+	1706, 1715, 1726, 1734, 1742, 1750, 1760, 1771, 1781, 1789, 1797, 1806, 1817, 1826, 1834, 1842,
+	1962, 1972, 1982, 1992, 2001, 2010, 2021, 2031, 1929, 1939, 1946, 1955, 1963, 1972, 1980, 1989,
+	1999, 2006, 2016, 2025, 2035, 2043, 2052, 2059, 2068, 2077, 2086, 2095, 2104, 2114, 2122, 2133,
+	2142, 2150, 2158, 2167, 2177, 2187, 2196, 2205, 2213, 2223, 2233, 2242, 2250, 2258, 2267, 2275,
+	2284, 2292, 2301, 2309, 2319, 2440, 2450, 2458, 2466, 2477, 2488, 2496, 2504, 2402, 2411, 2420,
+	2429, 2436, 2443, 2454, 2463, 2473, 2480, 2491, 2500, 2509, 2519, 2526, 2533, 2540, 2551, 2561,
+	2571, 2578, 2585, 2593, 2600, 2602, 2603, 2601, 2601, 2600, 2599, 2597, 2596, 2598, 2598, 2598,
+	2596, 2596, 2598, 2598, 2596, 2594, 2593, 2593, 2593, 2596, 2706, 2708, 2710, 2711, 2713, 2713,
+	2715, 2714, 2603, 2602, 2602, 2602, 2603, 2603, 2604, 2602, 2601, 2601, 2601, 2602, 2601, 2601,
+	2600, 2602, 2603, 2601, 2601, 2600, 2599, 2599, 2599, 2597, 2597, 2599, 2600, 2598, 2601, 2601,
+	2600, 2601, 2601, 2600, 2598, 2600, 2600, 2601, 2602, 2602, 2601, 2600, 2601, 2600, 2600, 2713,
+	2712, 2712, 2712, 2712, 2711, 2713, 2712, 2598, 2600, 2599, 2600, 2603, 2602, 2601, 2600, 2602,
+	2599, 2601, 2599, 2597, 2597, 2597, 2598, 2598, 2601, 2601, 2603, 2605, 2608, 2607, 2607, 2607,
+	2607, 2606, 2604, 2601, 2599, 2598, 2597, 2597, 2594, 2594, 2595, 2597, 2598, 2600, 2601, 2599,
+};
+static const uint16_t vec_median[384] = {
+	295, 295, 295, 300, 317, 321, 324, 350, 358, 366, 377, 377, 381, 393, 413, 416,
+	419, 432, 455, 460, 471, 475, 475, 484, 494, 504, 512, 531, 537, 546, 553, 558,
+	572, 574, 584, 587, 608, 611, 629, 634, 636, 645, 661, 677, 680, 680, 697, 703,
+	719, 721, 721, 737, 750, 757, 761, 775, 779, 801, 805, 811, 820, 829, 850, 852,
+	864, 867, 870, 882, 890, 909, 910, 910, 932, 947, 963, 963, 968, 975, 976, 982,
+	1012, 1013, 1018, 1018, 1041, 1042, 1045, 1069, 1086, 1091, 1095, 1096, 1108, 1111, 1129, 1132,
+	1147, 1153, 1158, 1169, 1177, 1185, 1201, 1201, 1207, 1233, 1242, 1253, 1262, 1264, 1266, 1275,
+	1283, 1296, 1311, 1315, 1330, 1340, 1343, 1352, 1353, 1374, 1379, 1389, 1390, 1409, 1427, 1437,
+	1437, 1440, 1443, 1454, 1470, 1477, 1492, 1495, 1500, 1508, 1531, 1538, 1539, 1546, 1549, 1560,
+	1583, 1585, 1594, 1595, 1602, 1622, 1622, 1643, 1644, 1659, 1676, 1677, 1680, 1702, 1708, 1712,
+	1714, 1725, 1737, 1750, 1763, 1766, 1769, 1783, 1792, 1808, 1809, 1822, 1827, 1844, 1851, 1856,
+	1860, 1870, 1888, 1910, 1920, 1920, 1927, 1934, 1944, 1951, 1963, 1966, 1967, 1991, 1995, 1999,
+	2011, 2026, 2030, 2037, 2045, 2061, 2063, 2073, 2082, 2084, 2107, 2108, 2115, 2134, 2140, 2144,
+	2147, 2169, 2171, 2181, 2183, 2202, 2219, 2223, 2224, 2242, 2247, 2250, 2257, 2276, 2284, 2289,
+	2298, 2304, 2313, 2317, 2327, 2345, 2359, 2371, 2377, 2378, 2378, 2405, 2405, 2413, 2427, 2441,
+	2443, 2449, 2450, 2461, 2471, 2493, 2503, 2510, 2515, 2525, 2527, 2535, 2548, 2550, 2557, 2574,
+	2594, 2594, 2605, 2606, 2608, 2605, 2605, 2601, 2601, 2594, 2594, 2594, 2596, 2596, 2600, 2600,
+	2600, 2593, 2593, 2593, 2590, 2591, 2591, 2591, 2590, 2591, 2595, 2610, 2610, 2610, 2610, 2604,
+	2603, 2599, 2603, 2603, 2607, 2607, 2608, 2607, 2608, 2597, 2598, 2598, 2607, 2604, 2604, 2604,
+	2603, 2603, 2603, 2603, 2605, 2605, 2598, 2592, 2598, 2592, 2592, 2604, 2607, 2607, 2607, 2607,
+	2595, 2595, 2597, 2597, 2597, 2600, 2603, 2603, 2604, 2604, 2604, 2598, 2598, 2596, 2598, 2603,
+	2603, 2598, 2598, 2596, 2596, 2596, 2600, 2600, 2607, 2607, 2607, 2607, 2607, 2596, 2603, 2603,
+	2596, 2603, 2603, 2595, 2593, 2595, 2595, 2598, 2606, 2609, 2609, 2610, 2610, 2609, 2609, 2608,
+	2608, 2606, 2606, 2599, 2593, 2593, 2593, 2593, 2593, 2592, 2596, 2603, 2603, 2603, 2605, 2605,
+};
+static const uint16_t vec_cic[96] = {
+	189, 333, 371, 405, 611, 533, 515, 552, 584, 623, 659, 695, 728, 764, 803, 843,
+	874, 1020, 1058, 982, 1018, 1054, 1094, 1125, 1159, 1195, 1239, 1269, 1307, 1344, 1434, 1584,
+	1448, 1487, 1523, 1555, 1591, 1626, 1669, 1703, 1737, 1774, 1812, 1847, 2106, 1926, 1959, 1993,
+	2030, 2064, 2099, 2137, 2171, 2211, 2245, 2280, 2312, 2521, 2442, 2426, 2455, 2499, 2529, 2564,
+	2600, 2603, 2596, 2599, 2595, 2593, 2708, 2716, 2601, 2604, 2600, 2602, 2601, 2599, 2597, 2602,
+	2598, 2601, 2601, 2656, 2768, 2599, 2602, 2600, 2598, 2597, 2608, 2606, 2603, 2593, 2597, 2602,
+};
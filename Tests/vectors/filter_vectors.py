@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+"""Writes filter_vectors.h: a two-channel ADC trace interleaved as the DMA
+leaves it (pot, NTC) and the per-sample output of every filter on channel 0,
+computed here straight from the definitions in filter.h."""
+import random
+
+N = 384
+rnd = random.Random(4)
+pot, ntc = [], []
+for i in range(N):
+    base = 300 + i * 9 if i < 256 else 2600   # pot turned, then left alone
+    v = base + rnd.randint(-12, 12)
+    if i % 53 == 17:
+        v += 900                              # switching spike
+    pot.append(max(0, min(4095, v)))
+    ntc.append(1850 + rnd.randint(-5, 5))
+adc = [s for pair in zip(pot, ntc) for s in pair]
+
+def ema(x, shift, init):
+    acc, out = init << shift, []
+    for s in x:
+        acc -= acc >> shift
+        acc += s
+        out.append(acc >> shift)
+    return out
+
+def ma(x, n, init):
+    hist, out = [init] * n, []
+    for s in x:
+        hist = hist[1:] + [s]
+        out.append(sum(hist) // n)
+    return out
+
+def median(x, n, init):
+    hist, out = [init] * n, []
+    for s in x:
+        hist = hist[1:] + [s]
+        out.append(sorted(hist)[n // 2])
+    return out
+
+def cic(x, order, log2_rate):
+    r = 1 << log2_rate
+    out = []
+    for k in range(0, len(x) - r + 1, r):
+        # order-N CIC = N cascaded boxcars of length R, sampled every R
+        h = [1]
+        for _ in range(order):
+            h = [sum(h[j - m] for m in range(r) if 0 <= j - m < len(h)) for j in range(len(h) + r - 1)]
+        t = k + r - 1
+        y = sum(h[j] * x[t - j] for j in range(len(h)) if t - j >= 0)
+        out.append(y >> (order * log2_rate))
+    return out
+
+def arr(name, v):
+    lines = [', '.join(str(s) for s in v[i:i + 16]) for i in range(0, len(v), 16)]
+    return 'static const uint16_t %s[%d] = {\n\t%s,\n};\n' % (name, len(v), ',\n\t'.join(lines))
+
+with open('filter_vectors.h', 'w') as f:
+    f.write('/* Generated by filter_vectors.py, do not edit */\n')
+    f.write('#define VEC_N %d\n#define VEC_CH 2\n' % N)
+    f.write('#define VEC_EMA_SHIFT 4\n#define VEC_MA_LEN 8\n#define VEC_MEDIAN_LEN 5\n')
+    f.write('#define VEC_CIC_LOG2 2\n#define VEC_INIT %d\n' % pot[0])
+    f.write(arr('vec_adc', adc))
+    f.write(arr('vec_ema', ema(pot, 4, pot[0])))
+    f.write(arr('vec_ma', ma(pot, 8, pot[0])))
+    f.write(arr('vec_median', median(pot, 5, pot[0])))
+    f.write(arr('vec_cic', cic(pot, 2, 2)))